@@ -0,0 +1,372 @@
+// Differential fuzz & throughput harness: runs every saxion::algos function (and its faster variants) on large
+// random task sets, checks the results against the loops in reference_algos.h and reports the relative throughput.
+//
+// usage: algos_differential [task count = 100000] [seed = 1] [rounds = 3]
+// returns a non-zero exit code if any function disagrees with the reference, except for the algos functions
+// that are still known to be unfinished: those are reported as "stub" as long as they disagree.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "algos.h"
+#include "reference_algos.h"
+#include "sort_keys.h"
+#include "test_helper.h"
+#include "workload.h"
+
+namespace {
+
+    using saxion::task;
+    using tasks_type = std::vector<task>;
+
+    bool close(double lhs, double rhs) {
+        return std::abs(lhs - rhs) <= 1e-9 * std::max({1.0, std::abs(lhs), std::abs(rhs)});
+    }
+
+    std::vector<int> sorted_ids(tasks_type::const_iterator begin, tasks_type::const_iterator end) {
+        std::vector<int> ids;
+        std::transform(begin, end, std::back_inserter(ids), [](const task& t) { return t.id; });
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    std::vector<int> sorted_ids(const tasks_type& tasks) {
+        return sorted_ids(tasks.begin(), tasks.end());
+    }
+
+    bool same_completion(const task& lhs, const task& rhs) {
+        return lhs.deadline == rhs.deadline && lhs.priority == rhs.priority;
+    }
+
+    template <typename _Value>
+    std::string expected(const _Value& got, const _Value& want) {
+        std::ostringstream out;
+        out << "got " << got << ", expected " << want;
+        return out.str();
+    }
+
+    class harness {
+    public:
+        using clock_type = std::chrono::steady_clock;
+
+        harness(tasks_type tasks, int rounds) : tasks_(std::move(tasks)), rounds_(rounds) {}
+
+        // the "algos" variant of <function> is not implemented yet: a mismatch is expected and not counted
+        void expect_stub(const std::string& function) {
+            stubs_.insert(function);
+        }
+
+        // run(tasks) and ref(tasks) are each timed on fresh copies of the task set;
+        // compare(run result, tasks after run, ref result, tasks after ref) returns an empty string if they agree
+        template <typename _Run, typename _Ref, typename _Compare>
+        void check(const std::string& function, const std::string& variant, _Run run, _Ref ref, _Compare compare) {
+            row r{function, variant, {}, 0.0, 0.0};
+            try {
+                auto [run_result, run_tasks, run_time] = timed(run);
+                auto [ref_result, ref_tasks, ref_time] = timed(ref);
+                r.mismatch = compare(run_result, run_tasks, ref_result, ref_tasks);
+                r.run_ms = run_time;
+                r.ref_ms = ref_time;
+            } catch (const std::exception& e) {
+                r.mismatch = std::string("exception: ") + e.what();
+            }
+            rows_.push_back(std::move(r));
+        }
+
+        // returns the number of mismatches, without the ones of the known stubs
+        int report(std::ostream& out) const {
+            auto mismatches = 0, stubbed = 0;
+            out << std::left << std::setw(36) << "function" << std::setw(12) << "variant" << std::setw(10) << "status"
+                << std::right << std::setw(12) << "ms" << std::setw(12) << "ref ms" << std::setw(10) << "speedup" << "\n";
+            for (auto& r : rows_) {
+                out << std::left << std::setw(36) << r.function << std::setw(12) << r.variant
+                    << std::setw(10) << status(r)
+                    << std::right << std::fixed << std::setprecision(3)
+                    << std::setw(12) << r.run_ms << std::setw(12) << r.ref_ms
+                    << std::setw(9) << std::setprecision(2) << (r.run_ms > 0 ? r.ref_ms / r.run_ms : 0.0) << "x";
+                if (!r.mismatch.empty()) {
+                    out << "  " << r.mismatch;
+                    ++(stub(r) ? stubbed : mismatches);
+                }
+                out << "\n";
+            }
+            out << "\n" << mismatches << " of " << rows_.size() << " checks disagree with the reference";
+            if (stubbed > 0) {
+                out << ", " << stubbed << " known stubs not counted";
+            }
+            out << "\n";
+            return mismatches;
+        }
+
+    private:
+        struct row {
+            std::string function;
+            std::string variant;
+            std::string mismatch;
+            double run_ms = 0.0;
+            double ref_ms = 0.0;
+        };
+
+        bool stub(const row& r) const {
+            return r.variant == "algos" && stubs_.count(r.function) != 0;
+        }
+
+        const char* status(const row& r) const {
+            if (r.mismatch.empty()) {
+                return "ok";
+            }
+            return stub(r) ? "stub" : "MISMATCH";
+        }
+
+        static double elapsed_ms(clock_type::time_point start) {
+            return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        }
+
+        // the result of the last round, the tasks it left behind and the best time of all the rounds
+        template <typename _Fn>
+        auto timed(_Fn fn) {
+            auto best = std::numeric_limits<double>::max();
+            for (auto round = 1; round < rounds_; ++round) {
+                auto tasks = tasks_;
+                auto start = clock_type::now();
+                fn(tasks);
+                best = std::min(best, elapsed_ms(start));
+            }
+            auto tasks = tasks_;
+            auto start = clock_type::now();
+            auto result = fn(tasks);
+            best = std::min(best, elapsed_ms(start));
+            return std::make_tuple(std::move(result), std::move(tasks), best);
+        }
+
+        tasks_type tasks_;
+        int rounds_;
+        std::vector<row> rows_;
+        std::set<std::string> stubs_;
+    };
+}
+
+int main(int argc, char** argv) {
+    auto count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000ul;
+    auto seed = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1u;
+    auto rounds = argc > 3 ? std::max(1, std::atoi(argv[3])) : 3;
+
+    auto tasks = test_helper::random_tasks(count, seed);
+    tasks.emplace_back(test_helper::empty_task());
+    test_helper::random_shuffle(tasks);
+
+    auto now = test_helper::now();
+    auto person = test_helper::assignees()[1];
+    auto prio = 4;
+    auto n = static_cast<int>(tasks.size() / 3);
+    auto extension = test_helper::hour() * 7;
+    auto some_id = tasks[tasks.size() / 2].id;
+
+    std::cout << "algos differential harness: " << tasks.size() << " tasks, seed " << seed << ", best of " << rounds << " rounds\n\n";
+
+    saxion::algos algos;
+    harness h(tasks, rounds);
+    // the functions of the assignment that are still unfinished (their unit tests fail too)
+    for (auto function : {"add_assignee_to_task", "extract_tasks_with_deadline_before", "remove_all_finished", "get_nth_to_complete",
+                          "cost_burndown", "separate_by_deadline", "estimate_workload"}) {
+        h.expect_stub(function);
+    }
+
+    h.check("has_all_tasks_assigned", "algos",
+            [&](tasks_type& t) { return algos.has_all_tasks_assigned(t.begin(), t.end()); },
+            [&](tasks_type& t) { return reference_algos::has_all_tasks_assigned(t); },
+            [](bool got, auto&, bool want, auto&) { return got == want ? "" : expected(got, want); });
+
+    h.check("has_task_with_deadline_afer", "algos",
+            [&](tasks_type& t) { return algos.has_task_with_deadline_afer(t.begin(), t.end(), now + test_helper::day() * 29); },
+            [&](tasks_type& t) { return reference_algos::has_task_with_deadline_afer(t, now + test_helper::day() * 29); },
+            [](bool got, auto&, bool want, auto&) { return got == want ? "" : expected(got, want); });
+
+    h.check("remove_asignee_from_all", "algos",
+            [&](tasks_type& t) { algos.remove_asignee_from_all(t.begin(), t.end(), person); return 0; },
+            [&](tasks_type& t) { reference_algos::remove_asignee_from_all(t, person); return 0; },
+            [](int, const tasks_type& got, int, const tasks_type& want) {
+                return std::equal(got.begin(), got.end(), want.begin(), want.end(), [](auto& lhs, auto& rhs) {
+                    return lhs.assignees == rhs.assignees;
+                }) ? "" : "assignees differ";
+            });
+
+    h.check("extend_deadlines", "algos",
+            [&](tasks_type& t) { algos.extend_deadlines(t.begin(), t.end(), prio, extension); return 0; },
+            [&](tasks_type& t) { reference_algos::extend_deadlines(t, prio, extension); return 0; },
+            [](int, const tasks_type& got, int, const tasks_type& want) {
+                return std::equal(got.begin(), got.end(), want.begin(), want.end(), [](auto& lhs, auto& rhs) {
+                    return lhs.deadline == rhs.deadline;
+                }) ? "" : "deadlines differ";
+            });
+
+    h.check("count_tasks_with_deadlines_before", "algos",
+            [&](tasks_type& t) { return static_cast<long>(algos.count_tasks_with_deadlines_before(t.begin(), t.end(), now)); },
+            [&](tasks_type& t) { return reference_algos::count_tasks_with_deadlines_before(t, now); },
+            [](long got, auto&, long want, auto&) { return got == want ? "" : expected(got, want); });
+
+    h.check("add_assignee_to_task", "algos",
+            [&](tasks_type& t) { return algos.add_assignee_to_task(t.begin(), t.end(), some_id, "zack"); },
+            [&](tasks_type& t) { return reference_algos::add_assignee_to_task(t, some_id, "zack"); },
+            [](bool got, const tasks_type& got_tasks, bool want, const tasks_type& want_tasks) {
+                if (got != want) {
+                    return expected(got, want);
+                }
+                return std::equal(got_tasks.begin(), got_tasks.end(), want_tasks.begin(), want_tasks.end(),
+                                  [](auto& lhs, auto& rhs) {
+                                      return lhs.id == rhs.id && lhs.name == rhs.name && lhs.assignees == rhs.assignees;
+                                  }) ? std::string() : std::string("tasks differ");
+            });
+
+    h.check("get_tasks_with_priority", "algos",
+            [&](tasks_type& t) { return algos.get_tasks_with_priority(t.begin(), t.end(), prio); },
+            [&](tasks_type& t) { return reference_algos::get_tasks_with_priority(t, prio); },
+            [](const tasks_type& got, auto&, const tasks_type& want, auto&) {
+                return sorted_ids(got) == sorted_ids(want) ? "" : "returned tasks differ";
+            });
+
+    h.check("get_tasks_with_priority", "buffer",
+            [&, buffer = tasks_type()](tasks_type& t) mutable {
+                buffer.clear();
+                algos.get_tasks_with_priority(t.begin(), t.end(), prio, std::back_inserter(buffer));
+                return buffer;
+            },
+            [&](tasks_type& t) { return reference_algos::get_tasks_with_priority(t, prio); },
+            [](const tasks_type& got, auto&, const tasks_type& want, auto&) {
+                return sorted_ids(got) == sorted_ids(want) ? "" : "returned tasks differ";
+            });
+
+    h.check("extract_tasks_with_deadline_before", "algos",
+            [&](tasks_type& t) {
+                tasks_type extracted;
+                auto end = algos.extract_tasks_with_deadline_before(t.begin(), t.end(), std::back_inserter(extracted), now);
+                t.erase(end, t.end());
+                return extracted;
+            },
+            [&](tasks_type& t) { return reference_algos::extract_tasks_with_deadline_before(t, now); },
+            [](const tasks_type& got, const tasks_type& got_kept, const tasks_type& want, const tasks_type& want_kept) {
+                if (sorted_ids(got) != sorted_ids(want)) {
+                    return expected(got.size(), want.size()) + " extracted tasks";
+                }
+                return sorted_ids(got_kept) == sorted_ids(want_kept) ? std::string() : std::string("kept tasks differ");
+            });
+
+    h.check("list_sorted_by_prio", "algos",
+            [&](tasks_type& t) { return algos.list_sorted_by_prio(t.begin(), t.end()); },
+            [&](tasks_type& t) { return reference_algos::list_sorted_by_prio(t); },
+            [](auto& got, auto&, auto& want, auto&) { return got == want ? "" : "lists differ"; });
+
+    h.check("remove_all_finished", "algos",
+            [&](tasks_type& t) { algos.remove_all_finished(t); return 0; },
+            [&](tasks_type& t) { reference_algos::remove_all_finished(t, test_helper::now()); return 0; },
+            [](int, const tasks_type& got, int, const tasks_type& want) {
+                return sorted_ids(got) == sorted_ids(want) ? "" : expected(got.size(), want.size()) + " tasks left";
+            });
+
+    auto compare_nth = [](const task& got, auto&, const task& want, auto&) {
+        return same_completion(got, want) ? std::string() : expected(got.id, want.id) + " (or a tie of it)";
+    };
+    h.check("get_nth_to_complete", "algos",
+            [&](tasks_type& t) { return algos.get_nth_to_complete(t.begin(), t.end(), n); },
+            [&](tasks_type& t) { return reference_algos::get_nth_to_complete(t, n); },
+            compare_nth);
+    h.check("get_nth_to_complete", "sort_keys",
+            [&](tasks_type& t) { return saxion::sort_keys().nth_to_complete(t.begin(), t.end(), static_cast<std::size_t>(n)); },
+            [&](tasks_type& t) { return reference_algos::get_nth_to_complete(t, n); },
+            compare_nth);
+
+    auto compare_first_n = [](const tasks_type& got, auto&, const tasks_type& want, auto&) {
+        return std::equal(got.begin(), got.end(), want.begin(), want.end(), same_completion)
+               ? std::string() : expected(got.size(), want.size()) + " tasks, or in the wrong order";
+    };
+    h.check("get_first_n_to_complete", "algos",
+            [&](tasks_type& t) { return algos.get_first_n_to_complete(t.begin(), t.end(), n); },
+            [&](tasks_type& t) { return reference_algos::get_first_n_to_complete(t, n); },
+            compare_first_n);
+    h.check("get_first_n_to_complete", "sort_keys",
+            [&](tasks_type& t) {
+                tasks_type first;
+                first.reserve(static_cast<std::size_t>(n));
+                saxion::sort_keys().first_n_to_complete(t.begin(), t.end(), static_cast<std::size_t>(n), std::back_inserter(first));
+                return first;
+            },
+            [&](tasks_type& t) { return reference_algos::get_first_n_to_complete(t, n); },
+            compare_first_n);
+
+    auto compare_burndown = [](const std::vector<double>& got, auto&, const std::vector<double>& want, auto&) {
+        return std::equal(got.begin(), got.end(), want.begin(), want.end(), close)
+               ? std::string() : expected(got.size(), want.size()) + " points, or wrong values";
+    };
+    h.check("cost_burndown", "algos",
+            [&](tasks_type& t) { std::vector<double> costs; algos.cost_burndown(t.begin(), t.end(), std::back_inserter(costs)); return costs; },
+            [&](tasks_type& t) { return reference_algos::cost_burndown(t); },
+            compare_burndown);
+    h.check("cost_burndown", "sort_keys",
+            [&](tasks_type& t) { std::vector<double> costs; saxion::sort_keys().cost_burndown(t.begin(), t.end(), std::back_inserter(costs)); return costs; },
+            [&](tasks_type& t) { return reference_algos::cost_burndown(t); },
+            compare_burndown);
+
+    h.check("cheapest_and_most_expensive", "algos",
+            [&](tasks_type& t) {
+                auto [cheap, expensive] = algos.cheapest_and_most_expensive(t.begin(), t.end());
+                return std::make_pair(cheap.cost, expensive.cost);
+            },
+            [&](tasks_type& t) { return reference_algos::cheapest_and_most_expensive_costs(t); },
+            [](auto& got, auto&, auto& want, auto&) { return got == want ? "" : "costs differ"; });
+
+    h.check("total_cost", "algos",
+            [&](tasks_type& t) { return static_cast<double>(algos.total_cost(t.begin(), t.end())); },
+            [&](tasks_type& t) { return reference_algos::total_cost(t); },
+            [](double got, auto&, double want, auto&) { return close(got, want) ? "" : expected(got, want); });
+
+    auto compare_cost = [](double got, auto&, double want, auto&) { return close(got, want) ? "" : expected(got, want); };
+    h.check("total_cost_of", "algos",
+            [&](tasks_type& t) { return algos.total_cost_of(t.begin(), t.end(), person); },
+            [&](tasks_type& t) { return reference_algos::total_cost_of(t, person); },
+            compare_cost);
+    h.check("total_cost_of", "workloads",
+            [&](tasks_type& t) { return saxion::workloads().assignee_workload_table(t.begin(), t.end()).find(person)->total_cost; },
+            [&](tasks_type& t) { return reference_algos::total_cost_of(t, person); },
+            compare_cost);
+
+    h.check("separate_by_deadline", "algos",
+            [&](tasks_type& t) { return algos.separate_by_deadline(t.begin(), t.end(), now) - t.begin(); },
+            [&](tasks_type& t) { return static_cast<tasks_type::difference_type>(reference_algos::count_tasks_with_deadlines_before(t, now)) - 1; },
+            [&](auto got, const tasks_type& got_tasks, auto want, auto&) {
+                if (got != want) {
+                    return expected(got, want) + " as the last index of the first group";
+                }
+                return std::is_partitioned(got_tasks.begin(), got_tasks.end(), [&](auto& t) { return t.deadline < now; })
+                       ? std::string() : std::string("tasks not partitioned");
+            });
+
+    // a sample of half the tasks lands within a few standard errors of the exact workload
+    auto compare_estimate = [&](double got, auto&, double want, auto&) {
+        auto half = static_cast<double>(tasks.size() / 2);
+        auto error = std::sqrt(want * (1 - want) / half) * 6 + 1e-9;
+        return std::abs(got - want) <= error ? std::string() : expected(got, want);
+    };
+    h.check("estimate_workload", "algos",
+            [&](tasks_type& t) { return algos.estimate_workload(t.begin(), t.end(), person); },
+            [&](tasks_type& t) { return reference_algos::workload(t, person); },
+            compare_estimate);
+    h.check("estimate_workload", "workloads",
+            [&](tasks_type& t) { return saxion::workloads().assignee_workload_table(t.begin(), t.end()).find(person)->workload; },
+            [&](tasks_type& t) { return reference_algos::workload(t, person); },
+            compare_estimate);
+
+    h.check("average_cost_of_prio", "algos",
+            [&](tasks_type& t) { return static_cast<double>(algos.average_cost_of_prio(t.begin(), t.end(), prio)); },
+            [&](tasks_type& t) { return reference_algos::average_cost_of_prio(t, prio); },
+            compare_cost);
+
+    return h.report(std::cout) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,76 @@
+// Export throughput of the task_exporter against the iostream path: task's operator<< (which writes only
+// id, name, priority and cost) and an std::ofstream writing the same CSV as the exporter field by field.
+//
+// usage: algos_export_throughput [task count = 1000000] [directory = system temp directory]
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "task_exporter.h"
+#include "test_helper.h"
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    // runs write(path) and reports the MB/s of the file it leaves behind
+    void measure(const std::string& name, const std::filesystem::path& path, std::size_t count,
+                 const std::function<void(const std::filesystem::path&)>& write) {
+        auto start = clock_type::now();
+        write(path);
+        auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        auto mb = static_cast<double>(std::filesystem::file_size(path)) / (1 << 20);
+        std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << mb << std::setw(10) << std::setprecision(3) << seconds
+                  << std::setw(10) << std::setprecision(1) << mb / seconds
+                  << std::setw(14) << std::setprecision(0) << static_cast<double>(count) / seconds << "\n";
+        std::filesystem::remove(path);
+    }
+}
+
+int main(int argc, char** argv) {
+    auto count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000ul;
+    auto directory = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::temp_directory_path();
+    auto tasks = test_helper::random_tasks(count, 42);
+
+    std::cout << "export: " << count << " tasks\n\n";
+    std::cout << std::left << std::setw(24) << "writer" << std::right << std::setw(10) << "MB"
+              << std::setw(10) << "s" << std::setw(10) << "MB/s" << std::setw(14) << "tasks/s" << "\n";
+
+    measure("ostream operator<<", directory / "algos_export.txt", count, [&tasks](auto& path) {
+        std::ofstream out(path);
+        for (auto& t : tasks) {
+            out << t << "\n";
+        }
+    });
+    measure("ostream csv", directory / "algos_export.csv", count, [&tasks](auto& path) {
+        std::ofstream out(path);
+        out << std::setprecision(std::numeric_limits<double>::max_digits10) << "id,name,priority,cost,deadline,assignees\n";
+        for (auto& t : tasks) {
+            out << t.id << ',' << t.name << ',' << t.priority << ',' << t.cost << ','
+                << std::chrono::duration_cast<std::chrono::nanoseconds>(t.deadline.time_since_epoch()).count() << ',';
+            for (auto name = t.assignees.begin(); name != t.assignees.end(); ++name) {
+                out << (name == t.assignees.begin() ? "" : ";") << *name;
+            }
+            out << '\n';
+        }
+    });
+
+    auto exporter = [&tasks](saxion::export_format format) {
+        return [&tasks, format](auto& path) {
+            saxion::task_exporter out(path, format);
+            out.write_tasks(tasks.begin(), tasks.end());
+        };
+    };
+    measure("task_exporter csv", directory / "algos_export.csv", count, exporter(saxion::export_format::csv));
+    measure("task_exporter ndjson", directory / "algos_export.ndjson", count, exporter(saxion::export_format::ndjson));
+    measure("task_exporter binary", directory / "algos_export.bin", count, exporter(saxion::export_format::binary));
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Out-of-core list_sorted_by_prio and cost_burndown on a binary task archive several times bigger than
+// the memory budget. The archive is generated batch by batch, so it never has to fit in memory either.
+//
+// usage: algos_external_sort [task count = 4000000] [memory budget in MB = 16] [temp directory = system default]
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "binary_format.h"
+#include "external_sort.h"
+#include "test_helper.h"
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_s(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    // an output iterator that only counts what is written to it, so the results don't have to fit in memory
+    struct counting_iterator {
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        std::size_t* count;
+
+        counting_iterator& operator*() { return *this; }
+        counting_iterator& operator++() { return *this; }
+        counting_iterator operator++(int) { return *this; }
+
+        template <typename _Value>
+        counting_iterator& operator=(const _Value&) {
+            ++*count;
+            return *this;
+        }
+    };
+
+    void write_archive(const std::filesystem::path& path, std::size_t count) {
+        constexpr std::size_t batch = 100000;
+        std::ofstream out(path, std::ios::binary);
+        std::vector<char> bytes;
+        for (std::size_t first = 0; first < count; first += batch) {
+            auto tasks = test_helper::random_tasks(std::min(batch, count - first), static_cast<unsigned>(first / batch + 1));
+            bytes.clear();
+            saxion::binary::writer writer(bytes);
+            for (auto& t : tasks) {
+                t.id += static_cast<int>(first);
+                writer.encode(t);
+            }
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+    }
+
+    void report(const std::string& function, const saxion::external_sort_stats& stats, std::size_t record_size, double seconds,
+                std::size_t budget) {
+        auto mb = static_cast<double>(stats.records * record_size) / (1 << 20);
+        std::cout << std::left << std::setw(22) << function << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << mb << " MB" << std::setw(8) << mb / (static_cast<double>(budget) / (1 << 20)) << "x"
+                  << std::setw(7) << stats.runs << std::setw(7) << stats.intermediate_merges
+                  << std::setw(8) << static_cast<double>(stats.peak_buffered_bytes) / (1 << 20) << " MB"
+                  << std::setw(10) << std::setprecision(2) << seconds
+                  << std::setw(12) << std::setprecision(0) << static_cast<double>(stats.records) / seconds << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    auto count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000ul;
+    auto budget = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16ul) << 20;
+
+    saxion::external_sort_options options;
+    options.memory_budget = budget;
+    if (argc > 3) {
+        options.temp_directory = argv[3];
+    }
+
+    auto archive = options.temp_directory / "algos_external_sort_bench.bin";
+    write_archive(archive, count);
+    std::cout << "external sort: " << count << " tasks, " << std::filesystem::file_size(archive) / (1 << 20)
+              << " MB archive, " << (budget >> 20) << " MB budget\n\n";
+    std::cout << std::left << std::setw(22) << "function" << std::right << std::setw(13) << "records"
+              << std::setw(9) << "budget" << std::setw(7) << "runs" << std::setw(7) << "merges" << std::setw(11) << "peak"
+              << std::setw(10) << "s" << std::setw(12) << "tasks/s" << "\n";
+
+    saxion::external_algos external(options);
+    {
+        std::ifstream in(archive, std::ios::binary);
+        std::size_t emitted = 0;
+        auto start = clock_type::now();
+        external.list_sorted_by_prio(saxion::binary::istream_task_iterator(in), saxion::binary::istream_task_iterator(),
+                                     counting_iterator{&emitted});
+        report("list_sorted_by_prio", external.stats(), 2 * sizeof(int), elapsed_s(start), budget);
+    }
+    {
+        std::ifstream in(archive, std::ios::binary);
+        std::size_t emitted = 0;
+        auto start = clock_type::now();
+        external.cost_burndown(saxion::binary::istream_task_iterator(in), saxion::binary::istream_task_iterator(),
+                               counting_iterator{&emitted});
+        report("cost_burndown", external.stats(), sizeof(std::int64_t) + sizeof(double), elapsed_s(start), budget);
+    }
+
+    std::filesystem::remove(archive);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Grouping tasks by name (count, total cost, min/max deadline, union of assignees): the hash aggregation
+// against sorting copies of the tasks with task::name_comparator and walking the runs of equal names.
+//
+// usage: algos_name_aggregation [task count = 1000000] [distinct names = 10000] [threads = hardware threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "name_aggregation.h"
+#include "test_helper.h"
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    std::vector<saxion::name_group> sort_and_group(const std::vector<saxion::task>& tasks) {
+        auto sorted = tasks;
+        std::sort(sorted.begin(), sorted.end(), saxion::task::name_comparator{});
+        std::vector<saxion::name_group> groups;
+        for (auto& t : sorted) {
+            if (groups.empty() || groups.back().name != t.name) {
+                groups.push_back(saxion::name_group{t.name, 0, 0.0, t.deadline, t.deadline, {}});
+            }
+            auto& g = groups.back();
+            ++g.count;
+            g.total_cost += t.cost;
+            g.earliest_deadline = std::min(g.earliest_deadline, t.deadline);
+            g.latest_deadline = std::max(g.latest_deadline, t.deadline);
+            g.assignees.insert(t.assignees.begin(), t.assignees.end());
+        }
+        return groups;
+    }
+
+    template <typename _Fn>
+    void measure(const std::string& name, std::size_t count, _Fn fn) {
+        auto start = clock_type::now();
+        auto groups = fn();
+        auto seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << groups.size()
+                  << std::fixed << std::setw(10) << std::setprecision(3) << seconds
+                  << std::setw(14) << std::setprecision(0) << static_cast<double>(count) / seconds << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    auto count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000ul;
+    auto names = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000ul;
+    auto threads = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : saxion::detail::default_thread_count();
+
+    auto tasks = test_helper::random_tasks(count, 44);
+    for (auto& t : tasks) {
+        t.name = "task " + std::to_string(static_cast<unsigned long>(t.id) * 7919 % names);
+    }
+
+    std::cout << "group by name: " << count << " tasks, " << names << " names, " << threads << " threads\n\n";
+    std::cout << std::left << std::setw(24) << "approach" << std::right << std::setw(10) << "groups"
+              << std::setw(10) << "s" << std::setw(14) << "tasks/s" << "\n";
+    measure("sort copies", count, [&tasks] { return sort_and_group(tasks); });
+    measure("hash, 1 thread", count, [&tasks] { return saxion::name_aggregation().group_by_name(tasks.begin(), tasks.end(), 1); });
+    measure("hash, " + std::to_string(threads) + " threads", count,
+            [&tasks, threads] { return saxion::name_aggregation().group_by_name(tasks.begin(), tasks.end(), threads); });
+    return 0;
+}
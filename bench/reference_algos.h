@@ -0,0 +1,197 @@
+#ifndef ALGOS_REFERENCE_ALGOS_H
+#define ALGOS_REFERENCE_ALGOS_H
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "task.h"
+
+// Straightforward loop implementations of the saxion::algos functions, written for obviousness, not speed.
+// They are the oracle the differential harness checks saxion::algos (and its faster variants) against.
+struct reference_algos {
+    using task = saxion::task;
+    using tasks_type = std::vector<task>;
+
+    static bool has_all_tasks_assigned(const tasks_type& tasks) {
+        for (auto& t : tasks) {
+            if (t.assignees.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool has_task_with_deadline_afer(const tasks_type& tasks, const task::time_type& deadline) {
+        for (auto& t : tasks) {
+            if (t.deadline > deadline) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void remove_asignee_from_all(tasks_type& tasks, const std::string& person) {
+        for (auto& t : tasks) {
+            t.assignees.erase(person);
+        }
+    }
+
+    static void extend_deadlines(tasks_type& tasks, int priority, const task::time_difference_type& extension) {
+        for (auto& t : tasks) {
+            if (t.priority == priority) {
+                t.deadline += extension;
+            }
+        }
+    }
+
+    static long count_tasks_with_deadlines_before(const tasks_type& tasks, const task::time_type& deadline) {
+        long count = 0;
+        for (auto& t : tasks) {
+            if (t.deadline < deadline) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    static bool add_assignee_to_task(tasks_type& tasks, int id, const std::string& person) {
+        for (auto& t : tasks) {
+            if (t.id == id) {
+                return t.assignees.insert(person).second;
+            }
+        }
+        return false;
+    }
+
+    static tasks_type get_tasks_with_priority(const tasks_type& tasks, int priority) {
+        tasks_type result;
+        for (auto& t : tasks) {
+            if (t.priority == priority) {
+                result.push_back(t);
+            }
+        }
+        return result;
+    }
+
+    // returns the tasks with deadlines before <deadline> and leaves only the others in <tasks>
+    static tasks_type extract_tasks_with_deadline_before(tasks_type& tasks, const task::time_type& deadline) {
+        tasks_type extracted, kept;
+        for (auto& t : tasks) {
+            (t.deadline < deadline ? extracted : kept).push_back(t);
+        }
+        tasks = kept;
+        return extracted;
+    }
+
+    static std::vector<std::tuple<int, int>> list_sorted_by_prio(const tasks_type& tasks) {
+        std::vector<std::tuple<int, int>> prio_id;
+        for (auto& t : tasks) {
+            prio_id.emplace_back(t.priority, t.id);
+        }
+        std::sort(prio_id.begin(), prio_id.end());
+        std::vector<std::tuple<int, int>> id_prio;
+        for (auto& [prio, id] : prio_id) {
+            id_prio.emplace_back(id, prio);
+        }
+        return id_prio;
+    }
+
+    static void remove_all_finished(tasks_type& tasks, const task::time_type& now) {
+        tasks_type kept;
+        for (auto& t : tasks) {
+            if (t.deadline > now) {
+                kept.push_back(t);
+            }
+        }
+        tasks = kept;
+    }
+
+    static tasks_type sorted_by_completion(const tasks_type& tasks) {
+        auto sorted = tasks;
+        std::stable_sort(sorted.begin(), sorted.end(), task::completion_comparator());
+        return sorted;
+    }
+
+    static task get_nth_to_complete(const tasks_type& tasks, int n) {
+        return sorted_by_completion(tasks)[static_cast<std::size_t>(n)];
+    }
+
+    static tasks_type get_first_n_to_complete(const tasks_type& tasks, int n) {
+        auto sorted = sorted_by_completion(tasks);
+        sorted.resize(std::min(sorted.size(), static_cast<std::size_t>(n)));
+        return sorted;
+    }
+
+    static std::vector<double> cost_burndown(const tasks_type& tasks) {
+        auto sorted = tasks;
+        std::stable_sort(sorted.begin(), sorted.end(), task::deadline_comparator());
+        std::vector<double> burndown;
+        auto sum = 0.0;
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            sum += sorted[i].cost;
+            if (i + 1 == sorted.size() || sorted[i + 1].deadline != sorted[i].deadline) {
+                burndown.push_back(sum);
+            }
+        }
+        return burndown;
+    }
+
+    // {0, 0} if there are no tasks
+    static std::pair<double, double> cheapest_and_most_expensive_costs(const tasks_type& tasks) {
+        if (tasks.empty()) {
+            return {0.0, 0.0};
+        }
+        auto min = tasks.front().cost, max = tasks.front().cost;
+        for (auto& t : tasks) {
+            min = std::min(min, t.cost);
+            max = std::max(max, t.cost);
+        }
+        return {min, max};
+    }
+
+    static double total_cost(const tasks_type& tasks) {
+        auto sum = 0.0;
+        for (auto& t : tasks) {
+            sum += t.cost;
+        }
+        return sum;
+    }
+
+    static double total_cost_of(const tasks_type& tasks, const std::string& assignee) {
+        auto sum = 0.0;
+        for (auto& t : tasks) {
+            if (t.assignees.count(assignee) == 1) {
+                sum += t.cost;
+            }
+        }
+        return sum;
+    }
+
+    // the exact workload algos::estimate_workload estimates
+    static double workload(const tasks_type& tasks, const std::string& person) {
+        std::size_t count = 0;
+        for (auto& t : tasks) {
+            if (t.assignees.count(person) == 1) {
+                ++count;
+            }
+        }
+        return tasks.empty() ? 0.0 : static_cast<double>(count) / static_cast<double>(tasks.size());
+    }
+
+    // 0 if there are no tasks with <priority>
+    static double average_cost_of_prio(const tasks_type& tasks, int priority) {
+        auto sum = 0.0;
+        auto count = 0;
+        for (auto& t : tasks) {
+            if (t.priority == priority) {
+                sum += t.cost;
+                ++count;
+            }
+        }
+        return count == 0 ? 0.0 : sum / count;
+    }
+};
+
+#endif //ALGOS_REFERENCE_ALGOS_H
@@ -0,0 +1,85 @@
+// Throughput of saxion::sharded_task_store against the shard count: writes are posted by <producers> threads
+// in batches of 256 tasks, queries are the scatter/gather versions of total_cost, count_tasks_with_deadlines_before,
+// get_first_n_to_complete(100) and cost_burndown.
+//
+// usage: algos_sharded_throughput [task count = 1000000] [max shards = 2 * hardware threads] [producers = 4]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "sharded_store.h"
+#include "test_helper.h"
+
+namespace {
+
+    using clock_type = std::chrono::steady_clock;
+
+    double elapsed_s(clock_type::time_point start) {
+        return std::chrono::duration<double>(clock_type::now() - start).count();
+    }
+
+    // posts the tasks from <producers> threads, each taking every producers-th batch
+    double insert_rate(saxion::sharded_task_store& store, const std::vector<saxion::task>& tasks, unsigned producers) {
+        constexpr std::size_t batch = 256;
+        auto start = clock_type::now();
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                for (auto first = p * batch; first < tasks.size(); first += producers * batch) {
+                    auto last = std::min(first + batch, tasks.size());
+                    store.insert(tasks.begin() + static_cast<std::ptrdiff_t>(first), tasks.begin() + static_cast<std::ptrdiff_t>(last));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        store.flush();
+        return static_cast<double>(tasks.size()) / elapsed_s(start);
+    }
+
+    double query_rate(const saxion::sharded_task_store& store, int rounds) {
+        auto cutoff = test_helper::now();
+        auto checksum = 0.0;
+        auto start = clock_type::now();
+        for (auto round = 0; round < rounds; ++round) {
+            checksum += store.total_cost();
+            checksum += static_cast<double>(store.count_tasks_with_deadlines_before(cutoff));
+            checksum += store.get_first_n_to_complete(100).front().cost;
+            std::vector<double> burndown;
+            store.cost_burndown(std::back_inserter(burndown));
+            checksum += burndown.back();
+        }
+        auto seconds = elapsed_s(start);
+        // keeps the queries from being optimized away
+        if (checksum < 0) {
+            std::cout << checksum;
+        }
+        return 4.0 * rounds / seconds;
+    }
+}
+
+int main(int argc, char** argv) {
+    auto count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000ul;
+    auto max_shards = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10))
+                               : 2 * saxion::detail::default_thread_count();
+    auto producers = argc > 3 ? std::max(1u, static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10))) : 4u;
+
+    auto tasks = test_helper::random_tasks(std::max(count, 1ul), 35);
+    std::cout << "sharded task store: " << tasks.size() << " tasks, " << producers << " producers, "
+              << std::thread::hardware_concurrency() << " hardware threads\n\n";
+    std::cout << std::setw(8) << "shards" << std::setw(18) << "inserts/s" << std::setw(14) << "queries/s" << "\n";
+
+    for (unsigned shards = 1; shards <= std::max(max_shards, 1u); shards *= 2) {
+        saxion::sharded_task_store store(shards);
+        auto inserts = insert_rate(store, tasks, producers);
+        auto queries = query_rate(store, 5);
+        std::cout << std::setw(8) << shards << std::fixed << std::setprecision(0)
+                  << std::setw(18) << inserts << std::setprecision(1) << std::setw(14) << queries << "\n";
+    }
+    return 0;
+}
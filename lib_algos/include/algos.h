@@ -6,304 +6,485 @@
 #define ALGOS_ALGOS_H
 
 #include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <random>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "task.h"
 
 namespace saxion {
+
     struct algos {
 
 
         // 1 point
         template<typename _Iter>
-        auto has_all_tasks_assigned(_Iter begin, _Iter end) const noexcept {
-            // todo done (1)
-            bool result = std::all_of(begin, end, []( const task i){
-              return !i.assignees.empty(); });
-            // returns true if all the tasks in collection have a person assigned to them
-            return  result;
-        }
+        bool has_all_tasks_assigned(_Iter begin, _Iter end) const noexcept;
 
         // 1 point
         template <typename _Iter>
-        bool has_task_with_deadline_afer(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept{
-            // todo done (1)
-          bool result = std::any_of(begin, end, [&deadline]( const task T) {
-              return T.deadline > deadline;
-          });
-                // returns true if any of the tasks in collection have a deadline after <deadline>
-            return result;
-        }
+        bool has_task_with_deadline_afer(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept;
 
         // 3 points
         template <typename _Iter>
-        auto remove_asignee_from_all(_Iter begin, _Iter end, const std::string& person) const noexcept{
-            // todo done (3)
-            // This function transforms all the tasks in place by removing the specific 'person'.
-            std::transform(begin, end, begin, [&person] (task& other_task) {
-                // Here, you are trying to find your specific 'person':
-                auto remove_person = std::find_if(other_task.assignees.begin(), other_task.assignees.end(), [&] (const std::string& name) {
-                    return name == person; // Check if the person is equal.
-                });
-
-                // Check if the iterator of 'remove_person' is equal not equal to your end iterator.
-                if (remove_person != other_task.assignees.end())
-                    other_task.assignees.erase(remove_person); // Remove the person from the assignees.
-                return other_task;
-            });
-        }
+        void remove_asignee_from_all(_Iter begin, _Iter end, const std::string& person) const noexcept;
 
         // 1 point done
         template <typename _Iter>
-        auto extend_deadlines(_Iter begin, _Iter end, int priority, const task::time_difference_type& extension) const noexcept{
-            // todo done (1)
-
-            // transforms the tasks with priority <prio> (in-place) by extending their deadlines with <extension>
-            std::transform(begin, end, begin, [&extension, &priority]( task& T){
-                if(T.priority == priority)
-                (T.deadline += extension);
-                return T ;});
-        }
+        void extend_deadlines(_Iter begin, _Iter end, int priority, const task::time_difference_type& extension) const noexcept;
 
         // 1 point done
         template <typename _Iter>
-        auto count_tasks_with_deadlines_before(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept{
-            // todo done (1)
-            (void)begin; (void)end; (void)deadline;
-            // returns the count of tasks with a deadline before <deadline>
-            int count = std::count_if(begin, end,[&](task T){return  T.deadline < deadline;} );
-            return count;
-        }
+        int count_tasks_with_deadlines_before(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept;
 
         // 2 points
         template <typename _Iter>
-        bool add_assignee_to_task(_Iter begin, _Iter end, int id, std::string person) const noexcept{
-            // todo
-            // adds <person> to assignees of the task with id <id>
-            // returns false if such a task doesn't exist or if it already has <person> assigned to it
-            // otherwise returns true
-           // std::transform(begin, end, begin, [&](const task ))            return false;
-            bool check = false;
-            std::transform(begin, end, begin, [&](task T) {
-                if (T.id == id) {
-                    if(T.name.empty())
-                        check = false;
-                    T.name = std::move(person);
-                }
-                return T;
-            });
-            check = std::any_of(begin, end, [&](const task T) { return (T.name.compare(person)); });
-
-            return  check;
-        }
+        bool add_assignee_to_task(_Iter begin, _Iter end, int id, std::string person) const noexcept;
 
         // 1 point
         template <typename _Iter>
-        std::vector<task> get_tasks_with_priority(_Iter begin, _Iter end, int priority) const noexcept{
-            // todo done (1)
-            std::vector<task> NewVec;
-            (void)begin; (void)end; (void)priority;
-            // returns a vector with copies of tasks with priority <priority>
-            std::copy_if(begin, end, std::back_inserter(NewVec), [&](task T){return T.priority == priority;});
-            return NewVec;
-        }
+        std::vector<task> get_tasks_with_priority(_Iter begin, _Iter end, int priority) const noexcept;
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter get_tasks_with_priority(_Iter begin, _Iter end, int priority, _OutIter out) const noexcept;
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter get_task_indices_with_priority(_Iter begin, _Iter end, int priority, _OutIter out) const noexcept;
 
         // 2 points move_if ;)
         template <typename _Iter, typename _OutIter>
-        _Iter extract_tasks_with_deadline_before(_Iter begin, _Iter end,  _OutIter out, const task::time_type& deadline) const noexcept{
-            // todo
-            (void)begin; (void)end; (void)out; (void)deadline;
-            // moves the tasks with deadlines before <deadline> to the container "pointed by" the <out> iterator (see test code for what it is)
-            // the tasks that are on or after the <deadline> should stay in the *beginning* of the original container
-            // the returned iterator should point to the 'new end' of the range in the original container
-
-            /* Simplified example:
-             * given an input container with integers: [6, 3, 7, 4, 5, 1]
-             * move the numbers before number {5} to another container and return the new 'end' iterator to the original container.
-             *
-             * After moving numbers 'before {5}' the output container will have elements: [3, 4, 1],
-             * while the original container will look like this: [6, 7, 5, _, _, _]
-             * Notice that there are three empty slots at the end of the container and all the number >= 5 have been moved to the beginning.
-             * The function should return the iterator to the 'new end' of the original container, which is the first empty slot.
-             */
-            return end;
-        }
+        _Iter extract_tasks_with_deadline_before(_Iter begin, _Iter end,  _OutIter out, const task::time_type& deadline) const noexcept;
 
         using id_prio = std::tuple<int, int>;
         // 2 points
         template <typename _Iter>
-        std::vector<id_prio> list_sorted_by_prio(_Iter begin, _Iter end) const noexcept{
-            // todo done (1)
-            (void)begin; (void)end;std::vector<id_prio> vector;
-
-            // returns a vector of pairs <id, priority> of all the tasks. The returned vector must be sorted by priority.
-            // If two tasks have the same priority, they are sorted by id (lower id comes first)
-            std::sort(begin, end, [](const task T, const task J){
-                if(T.priority != J.priority)
-                return T.priority < J.priority;
-                else
-                   return T.id < J.id;
-            });
-            std::for_each(begin, end,[&vector](const task& T){vector.emplace_back(T.id, T.priority);});
-           // std::move(begin, end, vector.cbegin(),[&vector](const task& T){vector.emplace_back(T.id, T.priority);});
-            return vector;
-        }
+        std::vector<id_prio> list_sorted_by_prio(_Iter begin, _Iter end) const noexcept;
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter list_sorted_by_prio(_Iter begin, _Iter end, _OutIter out) const noexcept;
 
         // 1 point
         template <typename _Cont>
-        auto remove_all_finished(_Cont& container) const noexcept{
-            // todo
-            (void)container;
-
-            // removes all the tasks with deadline before or on the time point now() obtained from the system_clock
-            // notice that this function takes the whole container as an argument, that's because it's impossible to remove elements using just the iterators.
-        }
+        void remove_all_finished(_Cont& container) const noexcept;
 
 
         // 1 point
         template <typename _Iter>
-        task& get_nth_to_complete(_Iter begin, _Iter end, int n) const noexcept{
-            // todo te doen
-            (void)begin; (void)end; (void)n;
-            // returns a reference to the n-th task to be completed in order of deadlines.
-            // deadline ties are resolved by comparing priorities (lower priorities come first)
-            _Iter found = std::find_if(begin, end, [&](task T){return T.priority < n;});
-            return *found;
-        }
+        task& get_nth_to_complete(_Iter begin, _Iter end, int n) const noexcept;
 
         // 1 point
         template <typename _Iter>
-        std::vector<task> get_first_n_to_complete(_Iter begin, _Iter end, int n) const noexcept{
-            // todo te doen
-            (void)begin; (void)end; (void)n;
-            // returns a vector with copies of first n tasks to complete by deadline (ties resolved with priority).
-            // The tasks in this vector must me sorted by deadline (ties resolved with priority)
-            return std::vector<task>();
-        }
+        std::vector<task> get_first_n_to_complete(_Iter begin, _Iter end, int n) const noexcept;
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter get_first_n_to_complete(_Iter begin, _Iter end, int n, _OutIter out) const noexcept;
 
         // 3 points
         template <typename _Iter, typename _OIter>
-        void cost_burndown(_Iter begin, _Iter end, _OIter obegin) const noexcept {
-            // todo
-            (void)begin; (void)end; (void)obegin;
-            // you can assume that _OIter is a std::back_insert_iterator to a container of double
-
-            // calculates the cost burndown of the tasks and writes the output to the output iterator <obegin>
-            // the cost burndown is defined as cumulative sum of the tasks' costs sorted by deadlines
-            // tasks with the same deadline contribute one data point (sum of their costs) to the burndown
-
-            /* Simplified example
-             * Assume that we have a container with 5 tasks, where each task has a deadline and a cost associated with it:
-             * [ {4, 43.0}, {2, 11.0}, {3, 7.0}, {1, 23.0}, {3, 19.0} ], here the first number in a pair is the deadline and the second the cost
-             * The first task to complete is the 4th task (deadline 1) with associated cost of 23.0
-             * The 2nd task to complete is the 2nd task (deadline 2) with associated cost of 11.0
-             * The 3rd tasks to complete are the 3rd and the 5th tasks (deadline 3) with associated costs of 7.0 + 19.0 = 26.0
-             * The 4th and last task to complete is the 1st task (deadline 4) with associated cost of 43.0
-             *
-             * Therefore the cost burndown (cumulative cost) is: [23.0, 34.0, 60.0, 103.0].
-             * Those numbers in this order must be outputted to the obegin iterator.
-             */
-        }
+        void cost_burndown(_Iter begin, _Iter end, _OIter obegin) const noexcept;
 
 
         // 1 point
         template <typename _Iter>
-        std::pair<task, task> cheapest_and_most_expensive(_Iter begin, _Iter end) const noexcept{
-            // todo done (1)
-           (void)begin; (void)end;
-
-            // returns a pair consisting of the least and the most expensive tasks in the collection
-           auto pair = std::minmax_element(begin, end,[](const task& T , const task& J){return T.cost < J.cost; });
+        std::pair<task, task> cheapest_and_most_expensive(_Iter begin, _Iter end) const noexcept;
 
-            return  {*pair.first, *pair.second};;
-        }
+        template <typename _Iter>
+        std::pair<_Iter, _Iter> find_cheapest_and_most_expensive(_Iter begin, _Iter end) const noexcept;
 
         // 1 point
         template <typename _Iter>
-        auto total_cost(_Iter begin, _Iter end) const noexcept{
-            // todo done (1)
-
-
-         auto val =   std::accumulate(begin, end, 0.0, [](double cost, task T){return T.cost + cost;});
-
-            return val;
-        }
+        double total_cost(_Iter begin, _Iter end) const noexcept;
 
         // 2 points
         template <typename _Iter>
-        double total_cost_of(_Iter begin, _Iter end, const std::string& assignee) const noexcept{
-            // todo done (2)
-            (void)begin; (void)end; (void)assignee;
-            // returns the cost of all the tasks that have <assignee> assigned to them
-          auto sum =  std::accumulate(begin, end, 0.0f, [&assignee](double cost, task T){if(T.assignees.find(assignee) != T.assignees.end()){return T.cost + cost;} else return cost;});
-            return sum;
-        }
+        double total_cost_of(_Iter begin, _Iter end, const std::string& assignee) const noexcept;
 
         // 1 point
         template <typename _Iter>
-        _Iter separate_by_deadline(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept {
-            // todo
-            (void)begin; (void)end; (void)deadline;
-            // reorders the tasks in such a way that all tasks with deadlines before <deadline> precede the tasks with deadline on or after <deadline>
-            // returns the iterator to the last task in the first group (with deadlines before <deadline>)
-            return begin;
-        }
+        _Iter separate_by_deadline(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept;
 
         // 3 points
         template <typename _Iter>
-        double estimate_workload(_Iter begin, _Iter end, const std::string& person) const {
-            // todo
-            (void)begin; (void)end; (void)person;
-            // estimates the workload of a <person>
-            // the estimation is done as follows:
-            // - out of all the tasks, half of them (n_s) are chosen at random (sampled)
-            // - for the selected tasks a check is done, whether the <person> belongs to the task's assignees
-            // based on the number of tasks that checked positive (count) and the total number of sampled tasks (n_s) the estimated workload is calculated as:
-            // count / n_s
-
-            /* Simplified example:
-             * There are 8 tasks and "zack" is assigned to tasks [2, 3, 6].
-             * We can construct a truth table of all tasks like this: [0, 0, 1, 1, 0, 0, 1, 0]
-             * The true workload of "zack" is 3/8=0.375
-             *
-             * Let's say for the estimate we sampled tasks: 0, 2, 4, 6. For those sampled tasks "zack" is assigned 2 two times,
-             * consequently the estimated workload is 2/4 = 0.5
-             *
-             * Let's now say that we randomly sampled tasks 1, 4, 6, 7. For those tasks "zack" appears only once,
-             * therefore the estimated workload is 1/4 = 0.25
-             *
-             * Notice that for our example it is possible to estimate a workload between 0.00 & 0.75
-             */
-
-            return -1.0;
-        }
+        double estimate_workload(_Iter begin, _Iter end, const std::string& person) const;
 
 
         // 2 points
         template <typename _Iter>
-        auto average_cost_of_prio(_Iter begin ,_Iter end, int priority) const noexcept{
-            // todo done (2)
-            (void)begin; (void)end; (void)priority;
-            int count = 0;
-           /* auto sum =  std::accumulate(begin, end, 0.0f, [&assignee](double cost, task T){
-                if(T.assignees.find(assignee) != T.assignees.end()){return T.cost + cost;} else return cost;});
-            return sum;*/
-            // calculates and returns the average cost of tasks with priority <priority>
-            double avg_cost = std::accumulate(begin, end,0.0, [&]( double cost,  task& T){
-                if(priority == T.priority){
-                    ++count;
-                    return (T.cost + cost);
+        double average_cost_of_prio(_Iter begin ,_Iter end, int priority) const noexcept;
+    };
+}
+
+#endif //ALGOS_ALGOS_H
+
+// The member definitions. algos_library.h defines SAXION_ALGOS_USE_LIBRARY to leave them out, so that the translation
+// units linked with lib_algos_compiled call the library's copies; a header that calls the members with iterators the
+// library doesn't instantiate defines SAXION_ALGOS_DEFINITIONS before including this file to get them anyway.
+#if !defined(SAXION_ALGOS_USE_LIBRARY) || defined(SAXION_ALGOS_DEFINITIONS)
+#ifndef ALGOS_ALGOS_DEFINITIONS
+#define ALGOS_ALGOS_DEFINITIONS
+
+namespace saxion {
+
+    namespace detail {
+        // walks a range of tasks while counting the position; *it converts to the position of the task
+        template <typename _Iter>
+        class positioned_iterator {
+        public:
+            struct positioned_task {
+                const task& t;
+                std::size_t position;
+
+                operator std::size_t() const noexcept {
+                    return position;
                 }
+            };
+
+            using iterator_category = std::input_iterator_tag;
+            using value_type = positioned_task;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = positioned_task;
+
+            positioned_iterator(_Iter it, std::size_t position) : it_(it), position_(position) {}
+
+            reference operator*() const { return {*it_, position_}; }
+
+            positioned_iterator& operator++() {
+                ++it_;
+                ++position_;
+                return *this;
+            }
+
+            positioned_iterator operator++(int) {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
 
-               return cost;
+            friend bool operator==(const positioned_iterator& lhs, const positioned_iterator& rhs) { return lhs.it_ == rhs.it_; }
+            friend bool operator!=(const positioned_iterator& lhs, const positioned_iterator& rhs) { return lhs.it_ != rhs.it_; }
+
+        private:
+            _Iter it_;
+            std::size_t position_;
+        };
+
+        // the number of tasks get_first_n_to_complete returns
+        template <typename _Iter>
+        std::size_t first_n_count(_Iter begin, _Iter end, int n) noexcept {
+            return std::min(static_cast<std::size_t>(std::max(n, 0)), static_cast<std::size_t>(std::distance(begin, end)));
+        }
+    }
+
+    template<typename _Iter>
+    bool algos::has_all_tasks_assigned(_Iter begin, _Iter end) const noexcept {
+        // todo done (1)
+        bool result = std::all_of(begin, end, []( const task i){
+          return !i.assignees.empty(); });
+        // returns true if all the tasks in collection have a person assigned to them
+        return  result;
+    }
+
+    template <typename _Iter>
+    bool algos::has_task_with_deadline_afer(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept {
+        // todo done (1)
+      bool result = std::any_of(begin, end, [&deadline]( const task T) {
+          return T.deadline > deadline;
+      });
+            // returns true if any of the tasks in collection have a deadline after <deadline>
+        return result;
+    }
+
+    template <typename _Iter>
+    void algos::remove_asignee_from_all(_Iter begin, _Iter end, const std::string& person) const noexcept {
+        // todo done (3)
+        // This function transforms all the tasks in place by removing the specific 'person'.
+        std::transform(begin, end, begin, [&person] (task& other_task) {
+            // Here, you are trying to find your specific 'person':
+            auto remove_person = std::find_if(other_task.assignees.begin(), other_task.assignees.end(), [&] (const std::string& name) {
+                return name == person; // Check if the person is equal.
             });
 
-            return avg_cost/count;
+            // Check if the iterator of 'remove_person' is equal not equal to your end iterator.
+            if (remove_person != other_task.assignees.end())
+                other_task.assignees.erase(remove_person); // Remove the person from the assignees.
+            return other_task;
+        });
+    }
+
+    template <typename _Iter>
+    void algos::extend_deadlines(_Iter begin, _Iter end, int priority, const task::time_difference_type& extension) const noexcept {
+        // todo done (1)
+
+        // transforms the tasks with priority <prio> (in-place) by extending their deadlines with <extension>
+        std::transform(begin, end, begin, [&extension, &priority]( task& T){
+            if(T.priority == priority)
+            (T.deadline += extension);
+            return T ;});
+    }
+
+    template <typename _Iter>
+    int algos::count_tasks_with_deadlines_before(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept {
+        // todo done (1)
+        (void)begin; (void)end; (void)deadline;
+        // returns the count of tasks with a deadline before <deadline>
+        int count = std::count_if(begin, end,[&](task T){return  T.deadline < deadline;} );
+        return count;
+    }
+
+    template <typename _Iter>
+    bool algos::add_assignee_to_task(_Iter begin, _Iter end, int id, std::string person) const noexcept {
+        // todo
+        // adds <person> to assignees of the task with id <id>
+        // returns false if such a task doesn't exist or if it already has <person> assigned to it
+        // otherwise returns true
+       // std::transform(begin, end, begin, [&](const task ))            return false;
+        bool check = false;
+        std::transform(begin, end, begin, [&](task T) {
+            if (T.id == id) {
+                if(T.name.empty())
+                    check = false;
+                T.name = std::move(person);
+            }
+            return T;
+        });
+        check = std::any_of(begin, end, [&](const task T) { return (T.name.compare(person)); });
+
+        return  check;
+    }
+
+    template <typename _Iter>
+    std::vector<task> algos::get_tasks_with_priority(_Iter begin, _Iter end, int priority) const noexcept {
+        // todo done (1)
+        std::vector<task> NewVec;
+        // returns a vector with copies of tasks with priority <priority>
+        get_tasks_with_priority(begin, end, priority, std::back_inserter(NewVec));
+        return NewVec;
+    }
+
+    template <typename _Iter, typename _OutIter>
+    _OutIter algos::get_tasks_with_priority(_Iter begin, _Iter end, int priority, _OutIter out) const noexcept {
+        // writes the tasks with priority <priority> to <out> and returns the end of the output
+        // <out> may point to a reused buffer (std::back_inserter of a cleared vector keeps its capacity),
+        // or to a container of std::reference_wrapper<const task> to get references instead of copies
+        return std::copy_if(begin, end, out, [priority](const task& T){return T.priority == priority;});
+    }
+
+    template <typename _Iter, typename _OutIter>
+    _OutIter algos::get_task_indices_with_priority(_Iter begin, _Iter end, int priority, _OutIter out) const noexcept {
+        // writes the positions (counted from <begin>) of the tasks with priority <priority> to <out>
+        return std::copy_if(detail::positioned_iterator<_Iter>(begin, 0), detail::positioned_iterator<_Iter>(end, 0), out,
+                            [priority](const auto& T){return T.t.priority == priority;});
+    }
+
+    template <typename _Iter, typename _OutIter>
+    _Iter algos::extract_tasks_with_deadline_before(_Iter begin, _Iter end,  _OutIter out, const task::time_type& deadline) const noexcept {
+        // todo
+        (void)begin; (void)end; (void)out; (void)deadline;
+        // moves the tasks with deadlines before <deadline> to the container "pointed by" the <out> iterator (see test code for what it is)
+        // the tasks that are on or after the <deadline> should stay in the *beginning* of the original container
+        // the returned iterator should point to the 'new end' of the range in the original container
+
+        /* Simplified example:
+         * given an input container with integers: [6, 3, 7, 4, 5, 1]
+         * move the numbers before number {5} to another container and return the new 'end' iterator to the original container.
+         *
+         * After moving numbers 'before {5}' the output container will have elements: [3, 4, 1],
+         * while the original container will look like this: [6, 7, 5, _, _, _]
+         * Notice that there are three empty slots at the end of the container and all the number >= 5 have been moved to the beginning.
+         * The function should return the iterator to the 'new end' of the original container, which is the first empty slot.
+         */
+        return end;
+    }
+
+    template <typename _Iter>
+    std::vector<algos::id_prio> algos::list_sorted_by_prio(_Iter begin, _Iter end) const noexcept {
+        // todo done (1)
+        std::vector<id_prio> vector;
+        vector.reserve(static_cast<std::size_t>(std::distance(begin, end)));
+
+        // returns a vector of pairs <id, priority> of all the tasks. The returned vector must be sorted by priority.
+        // If two tasks have the same priority, they are sorted by id (lower id comes first)
+        list_sorted_by_prio(begin, end, std::back_inserter(vector));
+        return vector;
+    }
+
+    template <typename _Iter, typename _OutIter>
+    _OutIter algos::list_sorted_by_prio(_Iter begin, _Iter end, _OutIter out) const noexcept {
+        // sorts the tasks by priority (ties by id) and writes their <id, priority> pairs to <out>
+        std::sort(begin, end, [](const task& T, const task& J){
+            if(T.priority != J.priority)
+            return T.priority < J.priority;
+            else
+               return T.id < J.id;
+        });
+        return std::transform(begin, end, out, [](const task& T){return id_prio(T.id, T.priority);});
+    }
+
+    template <typename _Cont>
+    void algos::remove_all_finished(_Cont& container) const noexcept {
+        // todo
+        (void)container;
+
+        // removes all the tasks with deadline before or on the time point now() obtained from the system_clock
+        // notice that this function takes the whole container as an argument, that's because it's impossible to remove elements using just the iterators.
+    }
+
+    template <typename _Iter>
+    task& algos::get_nth_to_complete(_Iter begin, _Iter end, int n) const noexcept {
+        // todo te doen
+        (void)begin; (void)end; (void)n;
+        // returns a reference to the n-th task to be completed in order of deadlines.
+        // deadline ties are resolved by comparing priorities (lower priorities come first)
+        _Iter found = std::find_if(begin, end, [&](task T){return T.priority < n;});
+        return *found;
+    }
+
+    template <typename _Iter>
+    std::vector<task> algos::get_first_n_to_complete(_Iter begin, _Iter end, int n) const noexcept {
+        // todo done (1)
+        // returns a vector with copies of first n tasks to complete by deadline (ties resolved with priority).
+        // The tasks in this vector must me sorted by deadline (ties resolved with priority)
+        std::vector<task> first(detail::first_n_count(begin, end, n));
+        std::partial_sort_copy(begin, end, first.begin(), first.end(), task::completion_comparator());
+        return first;
+    }
+
+    template <typename _Iter, typename _OutIter>
+    _OutIter algos::get_first_n_to_complete(_Iter begin, _Iter end, int n, _OutIter out) const noexcept {
+        // writes copies of the first n tasks to complete (sorted by deadline, ties resolved with priority) to <out>,
+        // leaving the range as it is; when <out> points to a buffer of n tasks they are selected right in the buffer.
+        // any other <out> (a back_inserter, an ostream iterator...) costs one temporary vector of n tasks per call,
+        // which are then moved into <out>, so <out> has to take tasks, not std::reference_wrapper<const task>
+        auto count = detail::first_n_count(begin, end, n);
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<_OutIter>::iterator_category>) {
+            return std::partial_sort_copy(begin, end, out, std::next(out, static_cast<std::ptrdiff_t>(count)), task::completion_comparator());
+        } else {
+            std::vector<task> first(count);
+            std::partial_sort_copy(begin, end, first.begin(), first.end(), task::completion_comparator());
+            return std::move(first.begin(), first.end(), out);
         }
-    };
+    }
+
+    template <typename _Iter, typename _OIter>
+    void algos::cost_burndown(_Iter begin, _Iter end, _OIter obegin) const noexcept {
+        // todo
+        (void)begin; (void)end; (void)obegin;
+        // you can assume that _OIter is a std::back_insert_iterator to a container of double
+
+        // calculates the cost burndown of the tasks and writes the output to the output iterator <obegin>
+        // the cost burndown is defined as cumulative sum of the tasks' costs sorted by deadlines
+        // tasks with the same deadline contribute one data point (sum of their costs) to the burndown
+
+        /* Simplified example
+         * Assume that we have a container with 5 tasks, where each task has a deadline and a cost associated with it:
+         * [ {4, 43.0}, {2, 11.0}, {3, 7.0}, {1, 23.0}, {3, 19.0} ], here the first number in a pair is the deadline and the second the cost
+         * The first task to complete is the 4th task (deadline 1) with associated cost of 23.0
+         * The 2nd task to complete is the 2nd task (deadline 2) with associated cost of 11.0
+         * The 3rd tasks to complete are the 3rd and the 5th tasks (deadline 3) with associated costs of 7.0 + 19.0 = 26.0
+         * The 4th and last task to complete is the 1st task (deadline 4) with associated cost of 43.0
+         *
+         * Therefore the cost burndown (cumulative cost) is: [23.0, 34.0, 60.0, 103.0].
+         * Those numbers in this order must be outputted to the obegin iterator.
+         */
+    }
+
+    template <typename _Iter>
+    std::pair<task, task> algos::cheapest_and_most_expensive(_Iter begin, _Iter end) const noexcept {
+        // todo done (1)
+
+        // returns a pair consisting of the least and the most expensive tasks in the collection
+       auto pair = find_cheapest_and_most_expensive(begin, end);
+
+        return  {*pair.first, *pair.second};
+    }
+
+    template <typename _Iter>
+    std::pair<_Iter, _Iter> algos::find_cheapest_and_most_expensive(_Iter begin, _Iter end) const noexcept {
+        // returns iterators to the least and the most expensive tasks in the collection, without copying them
+        return std::minmax_element(begin, end,[](const task& T , const task& J){return T.cost < J.cost; });
+    }
+
+    template <typename _Iter>
+    double algos::total_cost(_Iter begin, _Iter end) const noexcept {
+        // todo done (1)
+
+
+     auto val =   std::accumulate(begin, end, 0.0, [](double cost, task T){return T.cost + cost;});
+
+        return val;
+    }
+
+    template <typename _Iter>
+    double algos::total_cost_of(_Iter begin, _Iter end, const std::string& assignee) const noexcept {
+        // todo done (2)
+        (void)begin; (void)end; (void)assignee;
+        // returns the cost of all the tasks that have <assignee> assigned to them
+      auto sum =  std::accumulate(begin, end, 0.0f, [&assignee](double cost, task T){if(T.assignees.find(assignee) != T.assignees.end()){return T.cost + cost;} else return cost;});
+        return sum;
+    }
+
+    template <typename _Iter>
+    _Iter algos::separate_by_deadline(_Iter begin, _Iter end, const task::time_type& deadline) const noexcept {
+        // todo
+        (void)begin; (void)end; (void)deadline;
+        // reorders the tasks in such a way that all tasks with deadlines before <deadline> precede the tasks with deadline on or after <deadline>
+        // returns the iterator to the last task in the first group (with deadlines before <deadline>)
+        return begin;
+    }
+
+    template <typename _Iter>
+    double algos::estimate_workload(_Iter begin, _Iter end, const std::string& person) const {
+        // todo
+        (void)begin; (void)end; (void)person;
+        // estimates the workload of a <person>
+        // the estimation is done as follows:
+        // - out of all the tasks, half of them (n_s) are chosen at random (sampled)
+        // - for the selected tasks a check is done, whether the <person> belongs to the task's assignees
+        // based on the number of tasks that checked positive (count) and the total number of sampled tasks (n_s) the estimated workload is calculated as:
+        // count / n_s
+
+        /* Simplified example:
+         * There are 8 tasks and "zack" is assigned to tasks [2, 3, 6].
+         * We can construct a truth table of all tasks like this: [0, 0, 1, 1, 0, 0, 1, 0]
+         * The true workload of "zack" is 3/8=0.375
+         *
+         * Let's say for the estimate we sampled tasks: 0, 2, 4, 6. For those sampled tasks "zack" is assigned 2 two times,
+         * consequently the estimated workload is 2/4 = 0.5
+         *
+         * Let's now say that we randomly sampled tasks 1, 4, 6, 7. For those tasks "zack" appears only once,
+         * therefore the estimated workload is 1/4 = 0.25
+         *
+         * Notice that for our example it is possible to estimate a workload between 0.00 & 0.75
+         */
+
+        return -1.0;
+    }
+
+    template <typename _Iter>
+    double algos::average_cost_of_prio(_Iter begin ,_Iter end, int priority) const noexcept {
+        // todo done (2)
+        (void)begin; (void)end; (void)priority;
+        int count = 0;
+       /* auto sum =  std::accumulate(begin, end, 0.0f, [&assignee](double cost, task T){
+            if(T.assignees.find(assignee) != T.assignees.end()){return T.cost + cost;} else return cost;});
+        return sum;*/
+        // calculates and returns the average cost of tasks with priority <priority>
+        double avg_cost = std::accumulate(begin, end,0.0, [&]( double cost,  task& T){
+            if(priority == T.priority){
+                ++count;
+                return (T.cost + cost);
+            }
+
+           return cost;
+        });
+
+        return avg_cost/count;
+    }
 }
 
-
-#endif //ALGOS_ALGOS_H
+#endif //ALGOS_ALGOS_DEFINITIONS
+#endif
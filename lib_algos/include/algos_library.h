@@ -0,0 +1,92 @@
+#ifndef ALGOS_ALGOS_LIBRARY_H
+#define ALGOS_ALGOS_LIBRARY_H
+
+#include <deque>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The saxion::algos members compiled into lib_algos_compiled, for the iterators of std::vector<task>,
+// std::deque<task> and for task*, the members that don't change the tasks also for the const_iterators
+// of std::vector<task> and std::deque<task>; the output iterator overloads for back_inserters of std::vector.
+// Including this header leaves the member definitions out of algos.h and declares this set extern, so the
+// translation units linked with lib_algos_compiled neither parse nor instantiate (and optimize) the members
+// again: they call the library's copies. A member used with any other iterator does not link; define
+// SAXION_ALGOS_DEFINITIONS and include algos.h again to have the definitions (instrumentation.h does that).
+#ifndef SAXION_ALGOS_BUILDING_LIBRARY
+#define SAXION_ALGOS_USE_LIBRARY
+#endif
+
+#include "algos.h"
+#include "task.h"
+
+namespace saxion {
+    namespace library {
+        using vector_iterator = std::vector<task>::iterator;
+        using deque_iterator = std::deque<task>::iterator;
+        using vector_const_iterator = std::vector<task>::const_iterator;
+        using deque_const_iterator = std::deque<task>::const_iterator;
+        using pointer = task*;
+
+        using task_inserter = std::back_insert_iterator<std::vector<task>>;
+        using id_prio_inserter = std::back_insert_iterator<std::vector<algos::id_prio>>;
+        using index_inserter = std::back_insert_iterator<std::vector<std::size_t>>;
+        using cost_inserter = std::back_insert_iterator<std::vector<double>>;
+    }
+}
+
+// <prefix> is extern for the declarations, empty for the definitions in src/algos_library.cpp;
+// the READ_ONLY set are the members that don't change the tasks, which also work with const iterators
+#define SAXION_ALGOS_INSTANTIATE_READ_ONLY(prefix, ITER) \
+    prefix template bool algos::has_all_tasks_assigned<ITER>(ITER, ITER) const noexcept; \
+    prefix template bool algos::has_task_with_deadline_afer<ITER>(ITER, ITER, const task::time_type&) const noexcept; \
+    prefix template int algos::count_tasks_with_deadlines_before<ITER>(ITER, ITER, const task::time_type&) const noexcept; \
+    prefix template std::vector<task> algos::get_tasks_with_priority<ITER>(ITER, ITER, int) const noexcept; \
+    prefix template library::task_inserter algos::get_tasks_with_priority<ITER, library::task_inserter>( \
+            ITER, ITER, int, library::task_inserter) const noexcept; \
+    prefix template library::index_inserter algos::get_task_indices_with_priority<ITER, library::index_inserter>( \
+            ITER, ITER, int, library::index_inserter) const noexcept; \
+    prefix template std::vector<task> algos::get_first_n_to_complete<ITER>(ITER, ITER, int) const noexcept; \
+    prefix template library::task_inserter algos::get_first_n_to_complete<ITER, library::task_inserter>( \
+            ITER, ITER, int, library::task_inserter) const noexcept; \
+    prefix template std::pair<task, task> algos::cheapest_and_most_expensive<ITER>(ITER, ITER) const noexcept; \
+    prefix template std::pair<ITER, ITER> algos::find_cheapest_and_most_expensive<ITER>(ITER, ITER) const noexcept; \
+    prefix template double algos::total_cost<ITER>(ITER, ITER) const noexcept; \
+    prefix template double algos::total_cost_of<ITER>(ITER, ITER, const std::string&) const noexcept;
+
+#define SAXION_ALGOS_INSTANTIATE(prefix, ITER) \
+    SAXION_ALGOS_INSTANTIATE_READ_ONLY(prefix, ITER) \
+    prefix template void algos::remove_asignee_from_all<ITER>(ITER, ITER, const std::string&) const noexcept; \
+    prefix template void algos::extend_deadlines<ITER>(ITER, ITER, int, const task::time_difference_type&) const noexcept; \
+    prefix template bool algos::add_assignee_to_task<ITER>(ITER, ITER, int, std::string) const noexcept; \
+    prefix template ITER algos::extract_tasks_with_deadline_before<ITER, library::task_inserter>( \
+            ITER, ITER, library::task_inserter, const task::time_type&) const noexcept; \
+    prefix template std::vector<algos::id_prio> algos::list_sorted_by_prio<ITER>(ITER, ITER) const noexcept; \
+    prefix template library::id_prio_inserter algos::list_sorted_by_prio<ITER, library::id_prio_inserter>( \
+            ITER, ITER, library::id_prio_inserter) const noexcept; \
+    prefix template task& algos::get_nth_to_complete<ITER>(ITER, ITER, int) const noexcept; \
+    prefix template void algos::cost_burndown<ITER, library::cost_inserter>(ITER, ITER, library::cost_inserter) const noexcept; \
+    prefix template ITER algos::separate_by_deadline<ITER>(ITER, ITER, const task::time_type&) const noexcept; \
+    prefix template double algos::estimate_workload<ITER>(ITER, ITER, const std::string&) const; \
+    prefix template double algos::average_cost_of_prio<ITER>(ITER, ITER, int) const noexcept;
+
+#define SAXION_ALGOS_INSTANTIATE_CONTAINER(prefix, CONT) \
+    prefix template void algos::remove_all_finished<CONT>(CONT&) const noexcept;
+
+#define SAXION_ALGOS_INSTANTIATE_ALL(prefix) \
+    SAXION_ALGOS_INSTANTIATE(prefix, library::vector_iterator) \
+    SAXION_ALGOS_INSTANTIATE(prefix, library::deque_iterator) \
+    SAXION_ALGOS_INSTANTIATE(prefix, library::pointer) \
+    SAXION_ALGOS_INSTANTIATE_READ_ONLY(prefix, library::vector_const_iterator) \
+    SAXION_ALGOS_INSTANTIATE_READ_ONLY(prefix, library::deque_const_iterator) \
+    SAXION_ALGOS_INSTANTIATE_CONTAINER(prefix, std::vector<task>) \
+    SAXION_ALGOS_INSTANTIATE_CONTAINER(prefix, std::deque<task>)
+
+#ifndef SAXION_ALGOS_BUILDING_LIBRARY
+namespace saxion {
+    SAXION_ALGOS_INSTANTIATE_ALL(extern)
+}
+#endif
+
+#endif //ALGOS_ALGOS_LIBRARY_H
@@ -0,0 +1,188 @@
+#ifndef ALGOS_BATCH_QUERY_H
+#define ALGOS_BATCH_QUERY_H
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "task.h"
+#include "thread_pool.h"
+
+namespace saxion {
+
+    // one question asked to a batch_executor
+    struct query {
+        enum class kind {
+            total_cost_of,
+            count_tasks_with_deadlines_before,
+            average_cost_of_prio
+        };
+
+        kind what;
+        std::string assignee;
+        task::time_type deadline;
+        int priority = 0;
+
+        // same as algos::total_cost_of(begin, end, assignee)
+        static query total_cost_of(std::string assignee) {
+            return query{kind::total_cost_of, std::move(assignee), {}, 0};
+        }
+
+        // same as algos::count_tasks_with_deadlines_before(begin, end, deadline)
+        static query count_tasks_with_deadlines_before(const task::time_type& deadline) {
+            return query{kind::count_tasks_with_deadlines_before, {}, deadline, 0};
+        }
+
+        // same as algos::average_cost_of_prio(begin, end, priority), NaN if there are no such tasks
+        static query average_cost_of_prio(int priority) {
+            return query{kind::average_cost_of_prio, {}, {}, priority};
+        }
+    };
+
+    // Answers a batch of independent queries with one shared pass over the tasks instead of one pass per query.
+    // The pass is split in chunks of <grain> tasks run on a work_stealing_pool, every chunk evaluates all the queries
+    // into its own accumulators, which are summed up at the end.
+    class batch_executor {
+    public:
+        explicit batch_executor(work_stealing_pool& pool, std::size_t grain = 1 << 14)
+                : pool_(pool), grain_(grain == 0 ? 1 : grain) {}
+
+        // returns the answers in the order of the queries, counts are returned as (exact) doubles
+        template <typename _Iter>
+        std::vector<double> run(_Iter begin, _Iter end, const std::vector<query>& queries) const {
+            plan p(queries);
+            std::vector<accumulators> partial;
+
+            if constexpr (detail::is_random_access_v<_Iter>) {
+                auto size = static_cast<std::size_t>(end - begin);
+                auto chunks = (size + grain_ - 1) / grain_;
+                partial.assign(std::max<std::size_t>(chunks, 1), p.empty());
+                job_group group(pool_);
+                for (std::size_t c = 0; c < chunks; ++c) {
+                    group.run([&, c] {
+                        auto first = begin + static_cast<std::ptrdiff_t>(c * grain_);
+                        auto last = begin + static_cast<std::ptrdiff_t>(std::min(size, (c + 1) * grain_));
+                        std::for_each(first, last, [&](const task& t) { p.add(partial[c], t); });
+                    });
+                }
+                group.wait();
+            } else {
+                partial.assign(1, p.empty());
+                std::for_each(begin, end, [&](const task& t) { p.add(partial.front(), t); });
+            }
+
+            return p.answers(partial);
+        }
+
+    private:
+        struct accumulators {
+            std::vector<double> assignee_costs;
+            // deadline_counts[i] counts the tasks due on or after cutoff i - 1 and before cutoff i
+            std::vector<std::size_t> deadline_counts;
+            std::vector<double> priority_costs;
+            std::vector<std::size_t> priority_counts;
+        };
+
+        // the queries regrouped so that each task is looked at once for all of them
+        class plan {
+        public:
+            explicit plan(const std::vector<query>& queries) : queries_(queries) {
+                for (auto& q : queries) {
+                    switch (q.what) {
+                        case query::kind::total_cost_of:
+                            assignees_.try_emplace(q.assignee, assignees_.size());
+                            break;
+                        case query::kind::count_tasks_with_deadlines_before:
+                            cutoffs_.push_back(q.deadline);
+                            break;
+                        case query::kind::average_cost_of_prio:
+                            priorities_.try_emplace(q.priority, priorities_.size());
+                            break;
+                    }
+                }
+                std::sort(cutoffs_.begin(), cutoffs_.end());
+                cutoffs_.erase(std::unique(cutoffs_.begin(), cutoffs_.end()), cutoffs_.end());
+            }
+
+            accumulators empty() const {
+                return accumulators{std::vector<double>(assignees_.size(), 0.0),
+                                    std::vector<std::size_t>(cutoffs_.empty() ? 0 : cutoffs_.size() + 1, 0),
+                                    std::vector<double>(priorities_.size(), 0.0),
+                                    std::vector<std::size_t>(priorities_.size(), 0)};
+            }
+
+            void add(accumulators& acc, const task& t) const {
+                if (!assignees_.empty()) {
+                    for (auto& name : t.assignees) {
+                        auto it = assignees_.find(name);
+                        if (it != assignees_.end()) {
+                            acc.assignee_costs[it->second] += t.cost;
+                        }
+                    }
+                }
+                if (!cutoffs_.empty()) {
+                    ++acc.deadline_counts[static_cast<std::size_t>(
+                            std::upper_bound(cutoffs_.begin(), cutoffs_.end(), t.deadline) - cutoffs_.begin())];
+                }
+                if (!priorities_.empty()) {
+                    auto it = priorities_.find(t.priority);
+                    if (it != priorities_.end()) {
+                        acc.priority_costs[it->second] += t.cost;
+                        ++acc.priority_counts[it->second];
+                    }
+                }
+            }
+
+            std::vector<double> answers(const std::vector<accumulators>& partial) const {
+                auto total = empty();
+                for (auto& acc : partial) {
+                    sum_into(total.assignee_costs, acc.assignee_costs);
+                    sum_into(total.deadline_counts, acc.deadline_counts);
+                    sum_into(total.priority_costs, acc.priority_costs);
+                    sum_into(total.priority_counts, acc.priority_counts);
+                }
+                // count of tasks before cutoff i is the count of tasks in the buckets up to and including i
+                std::partial_sum(total.deadline_counts.begin(), total.deadline_counts.end(), total.deadline_counts.begin());
+
+                std::vector<double> result;
+                result.reserve(queries_.size());
+                std::transform(queries_.begin(), queries_.end(), std::back_inserter(result), [&](const query& q) {
+                    switch (q.what) {
+                        case query::kind::total_cost_of:
+                            return total.assignee_costs[assignees_.at(q.assignee)];
+                        case query::kind::count_tasks_with_deadlines_before: {
+                            auto i = std::lower_bound(cutoffs_.begin(), cutoffs_.end(), q.deadline) - cutoffs_.begin();
+                            return static_cast<double>(total.deadline_counts[static_cast<std::size_t>(i)]);
+                        }
+                        case query::kind::average_cost_of_prio: {
+                            auto i = priorities_.at(q.priority);
+                            return total.priority_counts[i] == 0 ? std::numeric_limits<double>::quiet_NaN()
+                                                                 : total.priority_costs[i] / static_cast<double>(total.priority_counts[i]);
+                        }
+                    }
+                    return std::numeric_limits<double>::quiet_NaN();
+                });
+                return result;
+            }
+
+        private:
+            template <typename _Value>
+            static void sum_into(std::vector<_Value>& total, const std::vector<_Value>& part) {
+                std::transform(total.begin(), total.end(), part.begin(), total.begin(), std::plus<>());
+            }
+
+            const std::vector<query>& queries_;
+            std::unordered_map<std::string, std::size_t> assignees_;
+            std::vector<task::time_type> cutoffs_;
+            std::unordered_map<int, std::size_t> priorities_;
+        };
+
+        work_stealing_pool& pool_;
+        std::size_t grain_;
+    };
+}
+
+#endif //ALGOS_BATCH_QUERY_H
@@ -0,0 +1,258 @@
+#ifndef ALGOS_BINARY_FORMAT_H
+#define ALGOS_BINARY_FORMAT_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "task.h"
+
+// The binary encoding of tasks shared by the mutation log, its snapshots and the bulk exporter.
+// All the integers are little endian; a task is encoded as:
+//   i32 id | i32 priority | f64 cost | i64 deadline (nanoseconds since the epoch) | str name | u32 count | str assignee...
+// where str is a u32 byte length followed by the bytes.
+
+namespace saxion {
+    namespace binary {
+
+        // CRC-32 (IEEE 802.3, the one of zlib), crc32(b, crc32(a)) == crc32 of a followed by b
+        inline std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0) noexcept {
+            static const auto table = [] {
+                std::array<std::uint32_t, 256> t{};
+                for (std::uint32_t i = 0; i < 256; ++i) {
+                    auto c = i;
+                    for (auto bit = 0; bit < 8; ++bit) {
+                        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    }
+                    t[i] = c;
+                }
+                return t;
+            }();
+            auto bytes = static_cast<const unsigned char*>(data);
+            crc = ~crc;
+            for (std::size_t i = 0; i < size; ++i) {
+                crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        // thrown when decoding runs out of bytes or meets an impossible value
+        struct format_error : std::runtime_error {
+            using std::runtime_error::runtime_error;
+        };
+
+        // appends encoded values to a byte buffer
+        class writer {
+        public:
+            explicit writer(std::vector<char>& buffer) : buffer_(buffer) {}
+
+            void u8(std::uint8_t v) { buffer_.push_back(static_cast<char>(v)); }
+            void u32(std::uint32_t v) { put(v, 4); }
+            void u64(std::uint64_t v) { put(v, 8); }
+            void i32(std::int32_t v) { u32(static_cast<std::uint32_t>(v)); }
+            void i64(std::int64_t v) { u64(static_cast<std::uint64_t>(v)); }
+
+            void f64(double v) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &v, sizeof bits);
+                u64(bits);
+            }
+
+            void str(const std::string& s) {
+                u32(static_cast<std::uint32_t>(s.size()));
+                buffer_.insert(buffer_.end(), s.begin(), s.end());
+            }
+
+            void time(const task::time_type& t) {
+                i64(std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+            }
+
+            void duration(const task::time_difference_type& d) {
+                i64(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+            }
+
+            void encode(const task& t) {
+                i32(t.id);
+                i32(t.priority);
+                f64(t.cost);
+                time(t.deadline);
+                str(t.name);
+                u32(static_cast<std::uint32_t>(t.assignees.size()));
+                for (auto& name : t.assignees) {
+                    str(name);
+                }
+            }
+
+        private:
+            void put(std::uint64_t v, int bytes) {
+                for (auto i = 0; i < bytes; ++i) {
+                    buffer_.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+                }
+            }
+
+            std::vector<char>& buffer_;
+        };
+
+        // decodes values from a byte range, throws format_error when it runs out of bytes
+        class reader {
+        public:
+            reader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+            std::uint8_t u8() { return static_cast<std::uint8_t>(get(1)); }
+            std::uint32_t u32() { return static_cast<std::uint32_t>(get(4)); }
+            std::uint64_t u64() { return get(8); }
+            std::int32_t i32() { return static_cast<std::int32_t>(u32()); }
+            std::int64_t i64() { return static_cast<std::int64_t>(u64()); }
+
+            double f64() {
+                auto bits = u64();
+                double v;
+                std::memcpy(&v, &bits, sizeof v);
+                return v;
+            }
+
+            std::string str() {
+                auto size = u32();
+                need(size);
+                std::string s(data_ + position_, size);
+                position_ += size;
+                return s;
+            }
+
+            task::time_type time() {
+                return task::time_type(std::chrono::duration_cast<task::time_difference_type>(std::chrono::nanoseconds(i64())));
+            }
+
+            task::time_difference_type duration() {
+                return std::chrono::duration_cast<task::time_difference_type>(std::chrono::nanoseconds(i64()));
+            }
+
+            task decode() {
+                task t;
+                t.id = i32();
+                t.priority = i32();
+                t.cost = f64();
+                t.deadline = time();
+                t.name = str();
+                auto count = u32();
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    t.assignees.emplace_hint(t.assignees.end(), str());
+                }
+                return t;
+            }
+
+            std::size_t position() const noexcept { return position_; }
+            std::size_t remaining() const noexcept { return size_ - position_; }
+
+        private:
+            void need(std::size_t bytes) const {
+                if (bytes > remaining()) {
+                    throw format_error("unexpected end of binary data");
+                }
+            }
+
+            std::uint64_t get(int bytes) {
+                need(static_cast<std::size_t>(bytes));
+                std::uint64_t v = 0;
+                for (auto i = 0; i < bytes; ++i) {
+                    v |= static_cast<std::uint64_t>(static_cast<unsigned char>(data_[position_ + i])) << (8 * i);
+                }
+                position_ += static_cast<std::size_t>(bytes);
+                return v;
+            }
+
+            const char* data_;
+            std::size_t size_;
+            std::size_t position_ = 0;
+        };
+
+        // reads the next encoded task from <in>; returns false if the stream ends before it,
+        // throws format_error if it ends halfway through a task
+        inline bool read(std::istream& in, task& t) {
+            char fixed[24];
+            if (!in.read(fixed, sizeof fixed)) {
+                if (in.gcount() == 0) {
+                    return false;
+                }
+                throw format_error("unexpected end of task stream");
+            }
+            auto u32 = [&in] {
+                char bytes[4];
+                if (!in.read(bytes, sizeof bytes)) {
+                    throw format_error("unexpected end of task stream");
+                }
+                return reader(bytes, sizeof bytes).u32();
+            };
+            auto str = [&in, &u32] {
+                std::string s(u32(), '\0');
+                if (!in.read(&s[0], static_cast<std::streamsize>(s.size()))) {
+                    throw format_error("unexpected end of task stream");
+                }
+                return s;
+            };
+
+            reader header(fixed, sizeof fixed);
+            t.id = header.i32();
+            t.priority = header.i32();
+            t.cost = header.f64();
+            t.deadline = header.time();
+            t.name = str();
+            t.assignees.clear();
+            for (auto count = u32(); count > 0; --count) {
+                t.assignees.emplace_hint(t.assignees.end(), str());
+            }
+            return true;
+        }
+
+        // an input iterator over the tasks encoded in a std::istream, the default constructed one is the end
+        class istream_task_iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = task;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const task*;
+            using reference = const task&;
+
+            istream_task_iterator() = default;
+
+            explicit istream_task_iterator(std::istream& in) : in_(&in) {
+                ++*this;
+            }
+
+            reference operator*() const { return current_; }
+            pointer operator->() const { return &current_; }
+
+            istream_task_iterator& operator++() {
+                if (!read(*in_, current_)) {
+                    in_ = nullptr;
+                }
+                return *this;
+            }
+
+            // the old position can't be read again, as with std::istream_iterator
+            istream_task_iterator operator++(int) {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
+
+            friend bool operator==(const istream_task_iterator& lhs, const istream_task_iterator& rhs) {
+                return lhs.in_ == rhs.in_;
+            }
+
+            friend bool operator!=(const istream_task_iterator& lhs, const istream_task_iterator& rhs) {
+                return !(lhs == rhs);
+            }
+
+        private:
+            std::istream* in_ = nullptr;
+            task current_{};
+        };
+    }
+}
+
+#endif //ALGOS_BINARY_FORMAT_H
@@ -0,0 +1,422 @@
+#ifndef ALGOS_BITMAP_INDEX_H
+#define ALGOS_BITMAP_INDEX_H
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "task.h"
+
+namespace saxion {
+
+    // A compressed set of 32-bit integers in the style of Roaring bitmaps:
+    // the values are grouped by their upper 16 bits, each group (container) holds the lower 16 bits either as
+    // a sorted array (up to 4096 values) or as a bitmap of 65536 bits, whichever is smaller.
+    class roaring_bitmap {
+    public:
+        roaring_bitmap() = default;
+
+        // the set [first, last)
+        static roaring_bitmap range(std::uint32_t first, std::uint32_t last) {
+            roaring_bitmap result;
+            for (auto v = first; v < last; ++v) {
+                result.add(v);
+            }
+            return result;
+        }
+
+        void add(std::uint32_t value) {
+            auto key = static_cast<std::uint16_t>(value >> 16);
+            // indexes are built in increasing order, so the last container is the likely one
+            auto it = !keys_.empty() && keys_.back() == key ? std::prev(keys_.end()) : std::lower_bound(keys_.begin(), keys_.end(), key);
+            auto i = static_cast<std::size_t>(it - keys_.begin());
+            if (it == keys_.end() || *it != key) {
+                keys_.insert(it, key);
+                containers_.insert(containers_.begin() + static_cast<std::ptrdiff_t>(i), container());
+            }
+            containers_[i].add(static_cast<std::uint16_t>(value & 0xffff));
+        }
+
+        bool contains(std::uint32_t value) const {
+            auto key = static_cast<std::uint16_t>(value >> 16);
+            auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+            return it != keys_.end() && *it == key &&
+                   containers_[static_cast<std::size_t>(it - keys_.begin())].contains(static_cast<std::uint16_t>(value & 0xffff));
+        }
+
+        std::uint64_t cardinality() const noexcept {
+            std::uint64_t count = 0;
+            for (auto& c : containers_) {
+                count += c.cardinality;
+            }
+            return count;
+        }
+
+        bool empty() const noexcept {
+            return containers_.empty();
+        }
+
+        // calls fn(value) for every value, in increasing order
+        template <typename _Fn>
+        void for_each(_Fn&& fn) const {
+            for (std::size_t i = 0; i < keys_.size(); ++i) {
+                auto high = static_cast<std::uint32_t>(keys_[i]) << 16;
+                containers_[i].for_each([&fn, high](std::uint16_t low) { fn(high | low); });
+            }
+        }
+
+        template <typename _OutIter>
+        _OutIter copy_to(_OutIter out) const {
+            for_each([&out](std::uint32_t v) { *out++ = v; });
+            return out;
+        }
+
+        std::size_t memory_bytes() const noexcept {
+            std::size_t bytes = keys_.size() * sizeof(std::uint16_t);
+            for (auto& c : containers_) {
+                bytes += sizeof(container) + c.array.size() * sizeof(std::uint16_t) + c.bits.size() * sizeof(std::uint64_t);
+            }
+            return bytes;
+        }
+
+        friend roaring_bitmap operator&(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+            return combine(lhs, rhs, false, false, &container::intersect);
+        }
+
+        friend roaring_bitmap operator|(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+            return combine(lhs, rhs, true, true, &container::unite);
+        }
+
+        // the values of <lhs> that are not in <rhs>
+        friend roaring_bitmap and_not(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+            return combine(lhs, rhs, true, false, &container::subtract);
+        }
+
+        roaring_bitmap& operator&=(const roaring_bitmap& rhs) {
+            return *this = *this & rhs;
+        }
+
+        roaring_bitmap& operator|=(const roaring_bitmap& rhs) {
+            return *this = *this | rhs;
+        }
+
+        friend bool operator==(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+            return lhs.keys_ == rhs.keys_ && lhs.containers_ == rhs.containers_;
+        }
+
+        friend bool operator!=(const roaring_bitmap& lhs, const roaring_bitmap& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        struct container {
+            static constexpr std::size_t array_limit = 4096;
+            static constexpr std::size_t words = 65536 / 64;
+
+            // one of the two is used: the sorted values, or the bitmap once there are more than array_limit of them
+            std::vector<std::uint16_t> array;
+            std::vector<std::uint64_t> bits;
+            std::uint32_t cardinality = 0;
+
+            bool is_bitmap() const noexcept {
+                return !bits.empty();
+            }
+
+            void add(std::uint16_t low) {
+                if (is_bitmap()) {
+                    auto& word = bits[low / 64];
+                    auto bit = std::uint64_t{1} << (low % 64);
+                    cardinality += (word & bit) ? 0 : 1;
+                    word |= bit;
+                    return;
+                }
+                auto it = array.empty() || array.back() < low ? array.end() : std::lower_bound(array.begin(), array.end(), low);
+                if (it != array.end() && *it == low) {
+                    return;
+                }
+                array.insert(it, low);
+                ++cardinality;
+                normalize();
+            }
+
+            bool contains(std::uint16_t low) const {
+                return is_bitmap() ? (bits[low / 64] >> (low % 64)) & 1
+                                   : std::binary_search(array.begin(), array.end(), low);
+            }
+
+            template <typename _Fn>
+            void for_each(_Fn&& fn) const {
+                if (!is_bitmap()) {
+                    std::for_each(array.begin(), array.end(), fn);
+                    return;
+                }
+                for (std::size_t w = 0; w < words; ++w) {
+                    for (auto word = bits[w]; word != 0; word &= word - 1) {
+                        fn(static_cast<std::uint16_t>(w * 64 + trailing_zeros(word)));
+                    }
+                }
+            }
+
+            // switches to the representation that fits the cardinality
+            void normalize() {
+                if (!is_bitmap() && array.size() > array_limit) {
+                    bits.assign(words, 0);
+                    for (auto low : array) {
+                        bits[low / 64] |= std::uint64_t{1} << (low % 64);
+                    }
+                    array.clear();
+                    array.shrink_to_fit();
+                } else if (is_bitmap() && cardinality <= array_limit) {
+                    array.reserve(cardinality);
+                    for_each([this](std::uint16_t low) { array.push_back(low); });
+                    bits.clear();
+                    bits.shrink_to_fit();
+                }
+            }
+
+            void count_bits() {
+                cardinality = 0;
+                for (auto word : bits) {
+                    cardinality += popcount(word);
+                }
+            }
+
+            static container from_array(std::vector<std::uint16_t> values) {
+                container c;
+                c.cardinality = static_cast<std::uint32_t>(values.size());
+                c.array = std::move(values);
+                c.normalize();
+                return c;
+            }
+
+            static container from_bits(std::vector<std::uint64_t> words) {
+                container c;
+                c.bits = std::move(words);
+                c.count_bits();
+                c.normalize();
+                return c;
+            }
+
+            // the bitmap form of a container, without changing it
+            static std::vector<std::uint64_t> as_bits(const container& c) {
+                if (c.is_bitmap()) {
+                    return c.bits;
+                }
+                std::vector<std::uint64_t> bits(words, 0);
+                for (auto low : c.array) {
+                    bits[low / 64] |= std::uint64_t{1} << (low % 64);
+                }
+                return bits;
+            }
+
+            static container intersect(const container& lhs, const container& rhs) {
+                if (!lhs.is_bitmap() && !rhs.is_bitmap()) {
+                    std::vector<std::uint16_t> values;
+                    std::set_intersection(lhs.array.begin(), lhs.array.end(), rhs.array.begin(), rhs.array.end(),
+                                          std::back_inserter(values));
+                    return from_array(std::move(values));
+                }
+                if (!lhs.is_bitmap() || !rhs.is_bitmap()) {
+                    auto& array = lhs.is_bitmap() ? rhs : lhs;
+                    auto& bitmap = lhs.is_bitmap() ? lhs : rhs;
+                    std::vector<std::uint16_t> values;
+                    std::copy_if(array.array.begin(), array.array.end(), std::back_inserter(values),
+                                 [&bitmap](std::uint16_t low) { return bitmap.contains(low); });
+                    return from_array(std::move(values));
+                }
+                std::vector<std::uint64_t> bits(words);
+                std::transform(lhs.bits.begin(), lhs.bits.end(), rhs.bits.begin(), bits.begin(),
+                               [](std::uint64_t l, std::uint64_t r) { return l & r; });
+                return from_bits(std::move(bits));
+            }
+
+            static container unite(const container& lhs, const container& rhs) {
+                if (!lhs.is_bitmap() && !rhs.is_bitmap() && lhs.cardinality + rhs.cardinality <= array_limit) {
+                    std::vector<std::uint16_t> values;
+                    std::set_union(lhs.array.begin(), lhs.array.end(), rhs.array.begin(), rhs.array.end(),
+                                   std::back_inserter(values));
+                    return from_array(std::move(values));
+                }
+                auto bits = as_bits(lhs);
+                if (rhs.is_bitmap()) {
+                    std::transform(bits.begin(), bits.end(), rhs.bits.begin(), bits.begin(),
+                                   [](std::uint64_t l, std::uint64_t r) { return l | r; });
+                } else {
+                    for (auto low : rhs.array) {
+                        bits[low / 64] |= std::uint64_t{1} << (low % 64);
+                    }
+                }
+                return from_bits(std::move(bits));
+            }
+
+            static container subtract(const container& lhs, const container& rhs) {
+                if (!lhs.is_bitmap()) {
+                    std::vector<std::uint16_t> values;
+                    std::copy_if(lhs.array.begin(), lhs.array.end(), std::back_inserter(values),
+                                 [&rhs](std::uint16_t low) { return !rhs.contains(low); });
+                    return from_array(std::move(values));
+                }
+                auto bits = lhs.bits;
+                if (rhs.is_bitmap()) {
+                    std::transform(bits.begin(), bits.end(), rhs.bits.begin(), bits.begin(),
+                                   [](std::uint64_t l, std::uint64_t r) { return l & ~r; });
+                } else {
+                    for (auto low : rhs.array) {
+                        bits[low / 64] &= ~(std::uint64_t{1} << (low % 64));
+                    }
+                }
+                return from_bits(std::move(bits));
+            }
+
+            friend bool operator==(const container& lhs, const container& rhs) {
+                return lhs.cardinality == rhs.cardinality && lhs.array == rhs.array && lhs.bits == rhs.bits;
+            }
+        };
+
+        static unsigned popcount(std::uint64_t word) noexcept {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+            return static_cast<unsigned>(std::bitset<64>(word).count());
+#endif
+        }
+
+        static unsigned trailing_zeros(std::uint64_t word) noexcept {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+            return popcount((word & (0 - word)) - 1);
+#endif
+        }
+
+        // merges the containers of both sides by key; keep_lhs / keep_rhs tell whether a container
+        // that is on one side only is part of the result
+        static roaring_bitmap combine(const roaring_bitmap& lhs, const roaring_bitmap& rhs, bool keep_lhs, bool keep_rhs,
+                                      container (*op)(const container&, const container&)) {
+            roaring_bitmap result;
+            std::size_t l = 0, r = 0;
+            auto push = [&result](std::uint16_t key, container c) {
+                if (c.cardinality > 0) {
+                    result.keys_.push_back(key);
+                    result.containers_.push_back(std::move(c));
+                }
+            };
+            while (l < lhs.keys_.size() || r < rhs.keys_.size()) {
+                if (r == rhs.keys_.size() || (l < lhs.keys_.size() && lhs.keys_[l] < rhs.keys_[r])) {
+                    if (keep_lhs) {
+                        push(lhs.keys_[l], lhs.containers_[l]);
+                    }
+                    ++l;
+                } else if (l == lhs.keys_.size() || rhs.keys_[r] < lhs.keys_[l]) {
+                    if (keep_rhs) {
+                        push(rhs.keys_[r], rhs.containers_[r]);
+                    }
+                    ++r;
+                } else {
+                    push(lhs.keys_[l], op(lhs.containers_[l], rhs.containers_[r]));
+                    ++l;
+                    ++r;
+                }
+            }
+            return result;
+        }
+
+        std::vector<std::uint16_t> keys_;
+        std::vector<container> containers_;
+    };
+
+    // Bitmap indexes over a range of tasks: one roaring_bitmap of task positions per priority and per assignee.
+    // Multi-predicate filters become bitmap operations, e.g. priority 3 or 4 assigned to both alice and bob:
+    //   (index.with_priority(3) | index.with_priority(4)) & index.assigned_to("alice") & index.assigned_to("bob")
+    // The index describes the range as it was when the index was built.
+    class task_bitmap_index {
+    public:
+        task_bitmap_index() = default;
+
+        template <typename _Iter>
+        task_bitmap_index(_Iter begin, _Iter end) {
+            std::uint32_t position = 0;
+            std::for_each(begin, end, [this, &position](const task& t) {
+                priorities_[t.priority].add(position);
+                std::for_each(t.assignees.begin(), t.assignees.end(), [this, position](const std::string& name) {
+                    assignees_[name].add(position);
+                });
+                ++position;
+            });
+            size_ = position;
+            all_ = roaring_bitmap::range(0, size_);
+        }
+
+        std::size_t size() const noexcept {
+            return size_;
+        }
+
+        // the positions of all the tasks
+        const roaring_bitmap& all() const noexcept {
+            return all_;
+        }
+
+        const roaring_bitmap& with_priority(int priority) const {
+            auto it = priorities_.find(priority);
+            return it == priorities_.end() ? none() : it->second;
+        }
+
+        // the tasks with a priority in [low, high]
+        roaring_bitmap with_priorities(int low, int high) const {
+            roaring_bitmap result;
+            std::for_each(priorities_.lower_bound(low), priorities_.upper_bound(high), [&result](auto& entry) {
+                result |= entry.second;
+            });
+            return result;
+        }
+
+        const roaring_bitmap& assigned_to(const std::string& assignee) const {
+            auto it = assignees_.find(assignee);
+            return it == assignees_.end() ? none() : it->second;
+        }
+
+        // the tasks without any assignee
+        roaring_bitmap unassigned() const {
+            roaring_bitmap assigned;
+            std::for_each(assignees_.begin(), assignees_.end(), [&assigned](auto& entry) { assigned |= entry.second; });
+            return and_not(all_, assigned);
+        }
+
+        // same as algos::has_all_tasks_assigned
+        bool has_all_tasks_assigned() const {
+            return unassigned().empty();
+        }
+
+        // the total cost of the tasks of <selection>; <begin> is the start of the indexed (random access) range
+        template <typename _Iter>
+        double total_cost(_Iter begin, const roaring_bitmap& selection) const {
+            auto sum = 0.0;
+            selection.for_each([&sum, begin](std::uint32_t position) {
+                sum += begin[static_cast<std::ptrdiff_t>(position)].cost;
+            });
+            return sum;
+        }
+
+        // same as algos::total_cost_of
+        template <typename _Iter>
+        double total_cost_of(_Iter begin, const std::string& assignee) const {
+            return total_cost(begin, assigned_to(assignee));
+        }
+
+    private:
+        static const roaring_bitmap& none() {
+            static const roaring_bitmap empty;
+            return empty;
+        }
+
+        std::uint32_t size_ = 0;
+        roaring_bitmap all_;
+        std::map<int, roaring_bitmap> priorities_;
+        std::map<std::string, roaring_bitmap> assignees_;
+    };
+}
+
+#endif //ALGOS_BITMAP_INDEX_H
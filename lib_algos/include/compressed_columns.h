@@ -0,0 +1,321 @@
+#ifndef ALGOS_COMPRESSED_COLUMNS_H
+#define ALGOS_COMPRESSED_COLUMNS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "task.h"
+
+namespace saxion {
+
+    // A column of integers stored in blocks, each block frame-of-reference encoded:
+    // the values minus the block minimum are bit-packed with just enough bits for the block's range.
+    // A block of consecutive values (min, min + 1, ...) is stored as a dense range without any bits.
+    class bit_packed_column {
+    public:
+        void append_block(const std::int64_t* values, std::size_t count) {
+            auto [min, max] = std::minmax_element(values, values + count);
+            block b{count == 0 ? 0 : *min, count == 0 ? 0 : *max, words_.size(), 0, false};
+            auto range = static_cast<std::uint64_t>(b.max) - static_cast<std::uint64_t>(b.min);
+
+            std::size_t consecutive = 0;
+            while (consecutive < count &&
+                   static_cast<std::uint64_t>(values[consecutive]) - static_cast<std::uint64_t>(b.min) == consecutive) {
+                ++consecutive;
+            }
+            b.dense = count > 1 && consecutive == count;
+            b.width = b.dense ? 0 : bits(range);
+
+            if (b.width > 0) {
+                words_.resize(words_.size() + (count * b.width + 63) / 64, 0);
+                for (std::size_t j = 0; j < count; ++j) {
+                    auto v = static_cast<std::uint64_t>(values[j]) - static_cast<std::uint64_t>(b.min);
+                    auto bit = j * b.width;
+                    auto& word = words_[b.first_word + bit / 64];
+                    word |= v << (bit % 64);
+                    if (bit % 64 + b.width > 64) {
+                        words_[b.first_word + bit / 64 + 1] |= v >> (64 - bit % 64);
+                    }
+                }
+            }
+            blocks_.push_back(b);
+        }
+
+        std::int64_t min(std::size_t block) const noexcept {
+            return blocks_[block].min;
+        }
+
+        std::int64_t max(std::size_t block) const noexcept {
+            return blocks_[block].max;
+        }
+
+        // the number of bits per value of the block, 0 for constant and dense blocks
+        unsigned width(std::size_t block) const noexcept {
+            return blocks_[block].width;
+        }
+
+        std::int64_t get(std::size_t block, std::size_t i) const noexcept {
+            auto& b = blocks_[block];
+            if (b.width == 0) {
+                return b.dense ? b.min + static_cast<std::int64_t>(i) : b.min;
+            }
+            return from_offset(b, extract(b, i * b.width));
+        }
+
+        // calls fn(i, value) for the first <count> values of the block, decoding them straight from the packed words
+        template <typename _Fn>
+        void for_each(std::size_t block, std::size_t count, _Fn&& fn) const {
+            auto& b = blocks_[block];
+            if (b.width == 0) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(i, b.dense ? b.min + static_cast<std::int64_t>(i) : b.min);
+                }
+                return;
+            }
+            for (std::size_t i = 0, bit = 0; i < count; ++i, bit += b.width) {
+                fn(i, from_offset(b, extract(b, bit)));
+            }
+        }
+
+        std::size_t memory_bytes() const noexcept {
+            return blocks_.size() * sizeof(block) + words_.size() * sizeof(std::uint64_t);
+        }
+
+    private:
+        struct block {
+            std::int64_t min;
+            std::int64_t max;
+            std::size_t first_word;
+            unsigned width;
+            bool dense;
+        };
+
+        static unsigned bits(std::uint64_t range) noexcept {
+            unsigned n = 0;
+            for (; range != 0; range >>= 1) {
+                ++n;
+            }
+            return n;
+        }
+
+        static std::int64_t from_offset(const block& b, std::uint64_t offset) noexcept {
+            return static_cast<std::int64_t>(static_cast<std::uint64_t>(b.min) + offset);
+        }
+
+        std::uint64_t extract(const block& b, std::size_t bit) const noexcept {
+            auto shift = bit % 64;
+            auto v = words_[b.first_word + bit / 64] >> shift;
+            if (shift + b.width > 64) {
+                v |= words_[b.first_word + bit / 64 + 1] << (64 - shift);
+            }
+            return b.width == 64 ? v : v & ((std::uint64_t{1} << b.width) - 1);
+        }
+
+        std::vector<block> blocks_;
+        std::vector<std::uint64_t> words_;
+    };
+
+    // The id, priority, cost and deadline of a range of tasks stored column-wise in compressed blocks of 1024 tasks:
+    //  - ids and priorities are frame-of-reference bit-packed, dense id ranges take no bits at all
+    //    and priorities 1..10 take 4 bits;
+    //  - deadlines are split in whole seconds, frame-of-reference bit-packed per block, and the ticks within the second,
+    //    which take no bits when all the deadlines of the block are whole seconds;
+    //  - costs are kept as doubles.
+    // Names and assignees are not stored. The kernels below work on the encoded blocks without decoding whole tasks
+    // and skip the blocks whose minimum and maximum already decide the answer.
+    class compressed_tasks {
+    public:
+        static constexpr std::size_t block_size = 1024;
+
+        compressed_tasks() = default;
+
+        template <typename _Iter>
+        compressed_tasks(_Iter begin, _Iter end) {
+            std::vector<std::int64_t> ids, priorities, seconds, ticks;
+            for (auto it = begin; it != end;) {
+                ids.clear();
+                priorities.clear();
+                seconds.clear();
+                ticks.clear();
+                auto min = std::numeric_limits<task::time_difference_type::rep>::max();
+                auto max = std::numeric_limits<task::time_difference_type::rep>::min();
+                for (; it != end && ids.size() < block_size; ++it) {
+                    const task& t = *it;
+                    auto since_epoch = t.deadline.time_since_epoch();
+                    auto whole = std::chrono::floor<std::chrono::seconds>(since_epoch);
+                    ids.push_back(t.id);
+                    priorities.push_back(t.priority);
+                    seconds.push_back(whole.count());
+                    ticks.push_back((since_epoch - whole).count());
+                    costs_.push_back(t.cost);
+                    min = std::min(min, since_epoch.count());
+                    max = std::max(max, since_epoch.count());
+                }
+                ids_.append_block(ids.data(), ids.size());
+                priorities_.append_block(priorities.data(), priorities.size());
+                seconds_.append_block(seconds.data(), seconds.size());
+                ticks_.append_block(ticks.data(), ticks.size());
+                deadline_ranges_.emplace_back(min, max);
+            }
+        }
+
+        std::size_t size() const noexcept {
+            return costs_.size();
+        }
+
+        std::size_t block_count() const noexcept {
+            return deadline_ranges_.size();
+        }
+
+        // the bytes taken by the encoded columns
+        std::size_t memory_bytes() const noexcept {
+            return ids_.memory_bytes() + priorities_.memory_bytes() + seconds_.memory_bytes() + ticks_.memory_bytes() +
+                   costs_.size() * sizeof(double) + deadline_ranges_.size() * sizeof(deadline_ranges_.front());
+        }
+
+        int id(std::size_t i) const noexcept {
+            return static_cast<int>(ids_.get(i / block_size, i % block_size));
+        }
+
+        int priority(std::size_t i) const noexcept {
+            return static_cast<int>(priorities_.get(i / block_size, i % block_size));
+        }
+
+        double cost(std::size_t i) const noexcept {
+            return costs_[i];
+        }
+
+        task::time_type deadline(std::size_t i) const noexcept {
+            auto block = i / block_size, j = i % block_size;
+            return task::time_type(std::chrono::seconds(seconds_.get(block, j)) +
+                                   task::time_difference_type(ticks_.get(block, j)));
+        }
+
+        // returns the index of the task with <id>, or size() if there is none
+        std::size_t find(int id) const noexcept {
+            for (std::size_t block = 0; block < block_count(); ++block) {
+                if (id < ids_.min(block) || id > ids_.max(block)) {
+                    continue;
+                }
+                for (std::size_t i = 0; i < block_length(block); ++i) {
+                    if (ids_.get(block, i) == id) {
+                        return block * block_size + i;
+                    }
+                }
+            }
+            return size();
+        }
+
+        // same as algos::count_tasks_with_deadlines_before
+        std::size_t count_tasks_with_deadlines_before(const task::time_type& deadline) const noexcept {
+            auto cutoff = deadline.time_since_epoch().count();
+            std::size_t count = 0;
+            for (std::size_t block = 0; block < block_count(); ++block) {
+                auto [min, max] = deadline_ranges_[block];
+                if (max < cutoff) {
+                    count += block_length(block);
+                } else if (min < cutoff) {
+                    for_each_deadline(block, [&count, cutoff](std::size_t, task::time_difference_type::rep d) {
+                        count += d < cutoff ? 1 : 0;
+                    });
+                }
+            }
+            return count;
+        }
+
+        // writes the ids of the tasks with deadlines before <deadline> to <out>
+        template <typename _OutIter>
+        _OutIter ids_with_deadlines_before(const task::time_type& deadline, _OutIter out) const {
+            auto cutoff = deadline.time_since_epoch().count();
+            for (std::size_t block = 0; block < block_count(); ++block) {
+                auto [min, max] = deadline_ranges_[block];
+                if (min >= cutoff) {
+                    continue;
+                }
+                for_each_deadline(block, [&](std::size_t i, task::time_difference_type::rep d) {
+                    if (d < cutoff) {
+                        *out++ = static_cast<int>(ids_.get(block, i));
+                    }
+                });
+            }
+            return out;
+        }
+
+        std::size_t count_tasks_with_priority(int priority) const noexcept {
+            std::size_t count = 0;
+            for_each_with_priority(priority, [&count](std::size_t) { ++count; });
+            return count;
+        }
+
+        // same as algos::total_cost
+        double total_cost() const noexcept {
+            return std::accumulate(costs_.begin(), costs_.end(), 0.0);
+        }
+
+        // same as algos::average_cost_of_prio, 0 if there are no such tasks
+        double average_cost_of_prio(int priority) const noexcept {
+            std::size_t count = 0;
+            auto sum = 0.0;
+            for_each_with_priority(priority, [&](std::size_t i) {
+                ++count;
+                sum += costs_[i];
+            });
+            return count == 0 ? 0.0 : sum / static_cast<double>(count);
+        }
+
+    private:
+        std::size_t block_length(std::size_t block) const noexcept {
+            return std::min(block_size, size() - block * block_size);
+        }
+
+        // calls fn(i, deadline ticks since the epoch) for every task of the block
+        template <typename _Fn>
+        void for_each_deadline(std::size_t block, _Fn&& fn) const {
+            using rep = task::time_difference_type::rep;
+            constexpr auto ticks_per_second = static_cast<rep>(task::time_difference_type::period::den /
+                                                               task::time_difference_type::period::num);
+            if (ticks_.min(block) == ticks_.max(block)) {
+                // whole seconds (or the same fraction everywhere), no need to look at the ticks column
+                auto fraction = static_cast<rep>(ticks_.min(block));
+                seconds_.for_each(block, block_length(block), [&](std::size_t i, std::int64_t s) {
+                    fn(i, static_cast<rep>(s) * ticks_per_second + fraction);
+                });
+            } else {
+                seconds_.for_each(block, block_length(block), [&](std::size_t i, std::int64_t s) {
+                    fn(i, static_cast<rep>(s) * ticks_per_second + static_cast<rep>(ticks_.get(block, i)));
+                });
+            }
+        }
+
+        // calls fn(index) for every task with <priority>, skipping the blocks without it
+        template <typename _Fn>
+        void for_each_with_priority(int priority, _Fn&& fn) const {
+            for (std::size_t block = 0; block < block_count(); ++block) {
+                if (priority < priorities_.min(block) || priority > priorities_.max(block)) {
+                    continue;
+                }
+                auto first = block * block_size;
+                priorities_.for_each(block, block_length(block), [&](std::size_t i, std::int64_t p) {
+                    if (p == priority) {
+                        fn(first + i);
+                    }
+                });
+            }
+        }
+
+        bit_packed_column ids_;
+        bit_packed_column priorities_;
+        bit_packed_column seconds_;
+        bit_packed_column ticks_;
+        std::vector<double> costs_;
+        // the earliest and latest deadline of every block, in ticks since the epoch
+        std::vector<std::pair<task::time_difference_type::rep, task::time_difference_type::rep>> deadline_ranges_;
+    };
+}
+
+#endif //ALGOS_COMPRESSED_COLUMNS_H
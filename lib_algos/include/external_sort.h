@@ -0,0 +1,310 @@
+#ifndef ALGOS_EXTERNAL_SORT_H
+#define ALGOS_EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algos.h"
+#include "task.h"
+
+namespace saxion {
+
+    struct external_sort_options {
+        // the bytes of records kept in memory, while building the sorted runs and while merging them;
+        // budgets of less than 4096 records are rounded up to that
+        std::size_t memory_budget = std::size_t{64} << 20;
+        // where the runs are spilled, in a private subdirectory that is removed afterwards
+        std::filesystem::path temp_directory = std::filesystem::temp_directory_path();
+    };
+
+    struct external_sort_stats {
+        std::size_t records = 0;
+        // the sorted runs written to disk, 0 if everything fit in the budget
+        std::size_t runs = 0;
+        // the merges of runs into bigger runs needed before the final merge
+        std::size_t intermediate_merges = 0;
+        std::uint64_t spilled_bytes = 0;
+        // the most bytes of records buffered at once: the run being built, or the read and write blocks of a merge
+        std::size_t peak_buffered_bytes = 0;
+    };
+
+    namespace detail {
+
+        // Sorts a stream of trivially copyable records with bounded memory: the records are collected in a buffer
+        // of the memory budget, which is sorted and spilled to disk as a run whenever it's full.
+        // drain() then merges the runs, first in groups if there are more than can be read at once within the budget.
+        template <typename _Record, typename _Less>
+        class external_sorter {
+            static_assert(std::is_trivially_copyable_v<_Record>, "runs are written as raw bytes");
+
+        public:
+            external_sorter(const external_sort_options& options, _Less less, external_sort_stats& stats)
+                    : options_(options), less_(less), stats_(stats),
+                      capacity_(std::max<std::size_t>(options.memory_budget / sizeof(_Record), min_buffer)) {
+                stats_ = external_sort_stats();
+            }
+
+            external_sorter(const external_sorter&) = delete;
+            external_sorter& operator=(const external_sorter&) = delete;
+
+            ~external_sorter() {
+                if (!directory_.empty()) {
+                    std::error_code ignored;
+                    std::filesystem::remove_all(directory_, ignored);
+                }
+            }
+
+            void push(const _Record& record) {
+                if (buffer_.size() == buffer_.capacity()) {
+                    // grows like a vector would, but never past the budget
+                    buffer_.reserve(std::min(capacity_, std::max(min_buffer, 2 * buffer_.size())));
+                    buffered(buffer_.capacity());
+                }
+                buffer_.push_back(record);
+                ++stats_.records;
+                if (buffer_.size() == capacity_) {
+                    std::sort(buffer_.begin(), buffer_.end(), less_);
+                    runs_.push_back(spill(buffer_.data(), buffer_.size()));
+                    buffer_.clear();
+                }
+            }
+
+            // calls fn(record) for all the pushed records in sorted order
+            template <typename _Fn>
+            void drain(_Fn&& fn) {
+                std::sort(buffer_.begin(), buffer_.end(), less_);
+                if (runs_.empty()) {
+                    std::for_each(buffer_.begin(), buffer_.end(), fn);
+                    return;
+                }
+                if (!buffer_.empty()) {
+                    runs_.push_back(spill(buffer_.data(), buffer_.size()));
+                }
+                buffer_.clear();
+                buffer_.shrink_to_fit();
+
+                // an intermediate merge buffers a block of every run it reads and a block of the run it writes,
+                // all within the budget; those blocks are min_buffer records, unless the budget is too small for two runs
+                auto fan_in = std::max<std::size_t>(2, capacity_ / min_buffer - 1);
+                auto output_block = capacity_ / (fan_in + 1);
+                while (runs_.size() > fan_in) {
+                    std::vector<std::filesystem::path> group(runs_.begin(), runs_.begin() + static_cast<std::ptrdiff_t>(fan_in));
+                    runs_.erase(runs_.begin(), runs_.begin() + static_cast<std::ptrdiff_t>(fan_in));
+                    auto merged = new_run();
+                    file out(merged, "wb");
+                    std::vector<_Record> block;
+                    block.reserve(output_block);
+                    merge(group, capacity_ - output_block, block.capacity(), [&](const _Record& r) {
+                        block.push_back(r);
+                        if (block.size() == output_block) {
+                            out.write(block.data(), block.size());
+                            block.clear();
+                        }
+                    });
+                    out.write(block.data(), block.size());
+                    runs_.push_back(merged);
+                    ++stats_.intermediate_merges;
+                }
+                // the final merge hands the records to fn, so the readers get all the budget
+                merge(runs_, capacity_, 0, fn);
+            }
+
+        private:
+            static constexpr std::size_t min_buffer = 4096;
+
+            class file {
+            public:
+                file(const std::filesystem::path& path, const char* mode) : path_(path), f_(std::fopen(path.string().c_str(), mode)) {
+                    if (f_ == nullptr) {
+                        throw std::system_error(errno, std::generic_category(), "cannot open " + path.string());
+                    }
+                }
+
+                file(const file&) = delete;
+                file& operator=(const file&) = delete;
+
+                ~file() {
+                    std::fclose(f_);
+                }
+
+                void write(const _Record* records, std::size_t count) {
+                    if (std::fwrite(records, sizeof(_Record), count, f_) != count) {
+                        throw std::system_error(errno, std::generic_category(), "cannot write " + path_.string());
+                    }
+                }
+
+                std::size_t read(_Record* records, std::size_t count) {
+                    return std::fread(records, sizeof(_Record), count, f_);
+                }
+
+            private:
+                std::filesystem::path path_;
+                std::FILE* f_;
+            };
+
+            // reads a run block by block
+            class run_reader {
+            public:
+                run_reader(const std::filesystem::path& path, std::size_t block) : file_(path, "rb"), buffer_(block) {}
+
+                bool next(_Record& r) {
+                    if (position_ == size_) {
+                        size_ = file_.read(buffer_.data(), buffer_.size());
+                        position_ = 0;
+                        if (size_ == 0) {
+                            return false;
+                        }
+                    }
+                    r = buffer_[position_++];
+                    return true;
+                }
+
+            private:
+                file file_;
+                std::vector<_Record> buffer_;
+                std::size_t position_ = 0;
+                std::size_t size_ = 0;
+            };
+
+            // k-way merge of the runs with a heap of the current record of every run, reading blocks of <read_budget> / runs
+            // records (<written> are buffered by fn); the run files are removed after
+            template <typename _Fn>
+            void merge(const std::vector<std::filesystem::path>& runs, std::size_t read_budget, std::size_t written, _Fn&& fn) {
+                auto block = std::max<std::size_t>(1, read_budget / runs.size());
+                std::vector<std::unique_ptr<run_reader>> readers;
+                for (auto& run : runs) {
+                    readers.push_back(std::make_unique<run_reader>(run, block));
+                }
+                buffered(block * runs.size() + written);
+
+                using head = std::pair<_Record, std::size_t>;
+                auto greater = [this](const head& lhs, const head& rhs) { return less_(rhs.first, lhs.first); };
+                std::priority_queue<head, std::vector<head>, decltype(greater)> heads(greater);
+                for (std::size_t i = 0; i < readers.size(); ++i) {
+                    _Record r;
+                    if (readers[i]->next(r)) {
+                        heads.emplace(r, i);
+                    }
+                }
+                while (!heads.empty()) {
+                    auto [r, i] = heads.top();
+                    heads.pop();
+                    fn(r);
+                    if (readers[i]->next(r)) {
+                        heads.emplace(r, i);
+                    }
+                }
+
+                readers.clear();
+                for (auto& run : runs) {
+                    std::filesystem::remove(run);
+                }
+            }
+
+            void buffered(std::size_t records) noexcept {
+                stats_.peak_buffered_bytes = std::max(stats_.peak_buffered_bytes, records * sizeof(_Record));
+            }
+
+            std::filesystem::path new_run() {
+                if (directory_.empty()) {
+                    std::random_device random;
+                    do {
+                        directory_ = options_.temp_directory / ("algos_sort_" + std::to_string(random()));
+                    } while (!std::filesystem::create_directories(directory_));
+                }
+                return directory_ / ("run_" + std::to_string(next_run_++) + ".bin");
+            }
+
+            std::filesystem::path spill(const _Record* records, std::size_t count) {
+                auto path = new_run();
+                file(path, "wb").write(records, count);
+                ++stats_.runs;
+                stats_.spilled_bytes += count * sizeof(_Record);
+                return path;
+            }
+
+            external_sort_options options_;
+            _Less less_;
+            external_sort_stats& stats_;
+            std::size_t capacity_;
+            std::vector<_Record> buffer_;
+            std::vector<std::filesystem::path> runs_;
+            std::filesystem::path directory_;
+            std::size_t next_run_ = 0;
+        };
+    }
+
+    // Out-of-core versions of the algos functions that need a full sort, for task streams bigger than memory.
+    // The input is read once and may be any input iterator range, e.g. binary::istream_task_iterator;
+    // only the few fields the result needs are kept per task.
+    class external_algos {
+    public:
+        explicit external_algos(external_sort_options options = {}) : options_(std::move(options)) {}
+
+        // same as algos::list_sorted_by_prio: <id, priority> pairs sorted by priority, ties by id
+        template <typename _InIter, typename _OutIter>
+        _OutIter list_sorted_by_prio(_InIter begin, _InIter end, _OutIter out) {
+            struct record {
+                int priority;
+                int id;
+            };
+            auto less = [](const record& lhs, const record& rhs) {
+                return lhs.priority != rhs.priority ? lhs.priority < rhs.priority : lhs.id < rhs.id;
+            };
+            detail::external_sorter<record, decltype(less)> sorter(options_, less, stats_);
+            std::for_each(begin, end, [&sorter](const task& t) { sorter.push(record{t.priority, t.id}); });
+            sorter.drain([&out](const record& r) { *out++ = algos::id_prio(r.id, r.priority); });
+            return out;
+        }
+
+        // same as algos::cost_burndown: the cumulative cost by deadline, one data point per deadline
+        template <typename _InIter, typename _OIter>
+        void cost_burndown(_InIter begin, _InIter end, _OIter obegin) {
+            struct record {
+                task::time_difference_type::rep deadline;
+                double cost;
+            };
+            auto less = [](const record& lhs, const record& rhs) { return lhs.deadline < rhs.deadline; };
+            detail::external_sorter<record, decltype(less)> sorter(options_, less, stats_);
+            std::for_each(begin, end, [&sorter](const task& t) {
+                sorter.push(record{t.deadline.time_since_epoch().count(), t.cost});
+            });
+
+            auto started = false;
+            auto deadline = task::time_difference_type::rep();
+            auto sum = 0.0;
+            sorter.drain([&](const record& r) {
+                if (started && r.deadline != deadline) {
+                    *obegin++ = sum;
+                }
+                started = true;
+                deadline = r.deadline;
+                sum += r.cost;
+            });
+            if (started) {
+                *obegin++ = sum;
+            }
+        }
+
+        // what the last call had to do
+        const external_sort_stats& stats() const noexcept {
+            return stats_;
+        }
+
+    private:
+        external_sort_options options_;
+        external_sort_stats stats_;
+    };
+}
+
+#endif //ALGOS_EXTERNAL_SORT_H
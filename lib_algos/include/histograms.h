@@ -0,0 +1,151 @@
+#ifndef ALGOS_HISTOGRAMS_H
+#define ALGOS_HISTOGRAMS_H
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "parallel.h"
+#include "task.h"
+
+namespace saxion {
+
+    // costs of tasks binned by deadline: bins[i] holds the total cost of the tasks with deadlines
+    // in [origin + i * bucket_width, origin + (i + 1) * bucket_width)
+    struct cost_bins {
+        task::time_type origin;
+        task::time_difference_type bucket_width;
+        std::vector<double> bins;
+        // total cost of the tasks with deadlines before <origin>
+        double before = 0.0;
+        // total cost of the tasks with deadlines on or after the end of the horizon
+        double after = 0.0;
+
+        task::time_type bucket_begin(std::size_t i) const {
+            return origin + bucket_width * static_cast<long long>(i);
+        }
+
+        // the cumulative cost at the end of each bucket, including the tasks due before <origin>
+        std::vector<double> burndown() const {
+            std::vector<double> cumulative(bins.size());
+            std::partial_sum(bins.begin(), bins.end(), cumulative.begin());
+            std::transform(cumulative.begin(), cumulative.end(), cumulative.begin(),
+                           [this](double cost) { return cost + before; });
+            return cumulative;
+        }
+
+        cost_bins& operator+=(const cost_bins& other) {
+            std::transform(bins.begin(), bins.end(), other.bins.begin(), bins.begin(), std::plus<>());
+            before += other.before;
+            after += other.after;
+            return *this;
+        }
+
+        friend cost_bins operator+(cost_bins lhs, const cost_bins& rhs) {
+            return lhs += rhs;
+        }
+    };
+
+    // Bins task::cost by task::deadline in one pass over the tasks, without sorting them.
+    // The range is split between <threads> threads, each filling its own histogram, merged at the end.
+    // The buckets cover [origin, origin + horizon), the last bucket may stretch past the horizon.
+    // All the functions throw std::invalid_argument if bucket_width isn't positive.
+    struct histograms {
+        // the minimal number of tasks a thread works on
+        static constexpr std::size_t grain = 1 << 14;
+
+        template <typename _Iter>
+        cost_bins cost_histogram(_Iter begin, _Iter end,
+                                 const task::time_difference_type& bucket_width,
+                                 const task::time_difference_type& horizon,
+                                 const task::time_type& origin = task::clock_type::now(),
+                                 unsigned threads = detail::default_thread_count()) const {
+            auto empty = empty_bins(bucket_width, horizon, origin);
+            std::vector<cost_bins> partial(detail::range_chunk_count(begin, end, threads, grain), empty);
+
+            detail::parallel_ranges(begin, end, threads, grain, [&](std::size_t c, _Iter first, _Iter last) {
+                auto& bins = partial[c];
+                std::for_each(first, last, [&bins](const task& t) { add(bins, t); });
+            });
+
+            return std::accumulate(partial.begin(), partial.end(), empty);
+        }
+
+        // one histogram per priority
+        template <typename _Iter>
+        std::map<int, cost_bins> cost_histogram_by_priority(_Iter begin, _Iter end,
+                                                            const task::time_difference_type& bucket_width,
+                                                            const task::time_difference_type& horizon,
+                                                            const task::time_type& origin = task::clock_type::now(),
+                                                            unsigned threads = detail::default_thread_count()) const {
+            return grouped<int>(begin, end, empty_bins(bucket_width, horizon, origin), threads,
+                                [](const task& t, auto&& emit) { emit(t.priority); });
+        }
+
+        // one histogram per assignee; a task with several assignees adds its full cost to each of them
+        template <typename _Iter>
+        std::map<std::string, cost_bins> cost_histogram_by_assignee(_Iter begin, _Iter end,
+                                                                    const task::time_difference_type& bucket_width,
+                                                                    const task::time_difference_type& horizon,
+                                                                    const task::time_type& origin = task::clock_type::now(),
+                                                                    unsigned threads = detail::default_thread_count()) const {
+            return grouped<std::string>(begin, end, empty_bins(bucket_width, horizon, origin), threads,
+                                        [](const task& t, auto&& emit) {
+                                            std::for_each(t.assignees.begin(), t.assignees.end(), emit);
+                                        });
+        }
+
+    private:
+        static cost_bins empty_bins(const task::time_difference_type& bucket_width,
+                                    const task::time_difference_type& horizon,
+                                    const task::time_type& origin) {
+            if (bucket_width.count() <= 0) {
+                throw std::invalid_argument("histograms: bucket_width must be positive");
+            }
+            auto count = horizon.count() <= 0 ? 0 : (horizon + bucket_width - task::time_difference_type(1)) / bucket_width;
+            return cost_bins{origin, bucket_width, std::vector<double>(static_cast<std::size_t>(count), 0.0)};
+        }
+
+        static void add(cost_bins& bins, const task& t) {
+            if (t.deadline < bins.origin) {
+                bins.before += t.cost;
+                return;
+            }
+            auto bucket = static_cast<std::size_t>((t.deadline - bins.origin) / bins.bucket_width);
+            if (bucket < bins.bins.size()) {
+                bins.bins[bucket] += t.cost;
+            } else {
+                bins.after += t.cost;
+            }
+        }
+
+        // keys_of(task, emit) calls emit(key) for every group the task belongs to
+        template <typename _Key, typename _Iter, typename _Keys>
+        static std::map<_Key, cost_bins> grouped(_Iter begin, _Iter end, const cost_bins& empty, unsigned threads,
+                                                 _Keys keys_of) {
+            std::vector<std::unordered_map<_Key, cost_bins>> partial(detail::range_chunk_count(begin, end, threads, grain));
+
+            detail::parallel_ranges(begin, end, threads, grain, [&](std::size_t c, _Iter first, _Iter last) {
+                auto& groups = partial[c];
+                std::for_each(first, last, [&](const task& t) {
+                    keys_of(t, [&](const _Key& key) {
+                        add(groups.try_emplace(key, empty).first->second, t);
+                    });
+                });
+            });
+
+            std::map<_Key, cost_bins> merged;
+            for (auto& groups : partial) {
+                for (auto& [key, bins] : groups) {
+                    merged.try_emplace(key, empty).first->second += bins;
+                }
+            }
+            return merged;
+        }
+    };
+}
+
+#endif //ALGOS_HISTOGRAMS_H
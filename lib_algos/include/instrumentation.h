@@ -0,0 +1,522 @@
+#ifndef ALGOS_INSTRUMENTATION_H
+#define ALGOS_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+// instrumented_algos forwards any iterator to algos, so it needs the member definitions next to algos_library.h too
+#define SAXION_ALGOS_DEFINITIONS
+#include "algos.h"
+
+// Opt-in hot path instrumentation of saxion::algos.
+//
+// Compile with SAXION_ALGOS_INSTRUMENT defined (cmake -DALGOS_INSTRUMENT=ON) and use saxion::instrumented_algos
+// instead of saxion::algos: every call records its call count, the number of elements in the range
+// (for random access iterators, other ranges record 0), its wall time (in a log2 histogram of nanoseconds) and the number of heap allocations it made.
+// Without the flag instrumented_algos is just another name for algos and nothing is recorded.
+//
+// Allocations are only counted in programs that put SAXION_ALGOS_DEFINE_ALLOCATION_HOOKS
+// in exactly one of their translation units (outside of any namespace); without the flag it expands to nothing,
+// so the global operator new and operator delete stay the standard ones.
+
+namespace saxion {
+    namespace instrumentation {
+
+        // bucket i counts calls that took [2^i, 2^(i+1)) nanoseconds, bucket 0 also counts calls under 1ns
+        constexpr std::size_t time_buckets = 40;
+
+        // a copy of the counters of one instrumented function
+        struct function_stats {
+            std::string name;
+            std::uint64_t calls = 0;
+            std::uint64_t elements = 0;
+            std::uint64_t allocations = 0;
+            std::uint64_t total_ns = 0;
+            std::array<std::uint64_t, time_buckets> time_histogram{};
+        };
+
+        namespace detail {
+            inline std::uint64_t& thread_allocations() noexcept {
+                thread_local std::uint64_t count = 0;
+                return count;
+            }
+
+            // returns the number of elements in [begin, end) for random access iterators and 0 for the others,
+            // so a probe never walks a list or a stream just to count it
+            template<typename _Iter>
+            std::uint64_t range_elements(_Iter begin, _Iter end) noexcept {
+                if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                        typename std::iterator_traits<_Iter>::iterator_category>) {
+                    return static_cast<std::uint64_t>(end - begin);
+                } else {
+                    return 0;
+                }
+            }
+        }
+
+        class probe_site;
+
+        // all the probe sites of the program
+        class registry {
+        public:
+            static registry& instance() {
+                static registry sites;
+                return sites;
+            }
+
+            void add(probe_site* site) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                sites_.push_back(site);
+            }
+
+            std::vector<function_stats> snapshot() const;
+
+            void reset();
+
+        private:
+            mutable std::mutex mutex_;
+            std::vector<probe_site*> sites_;
+        };
+
+        // the counters of one instrumented function, lives in a function local static
+        class probe_site {
+        public:
+            explicit probe_site(const char* name) : name_(name) {
+                registry::instance().add(this);
+            }
+
+            probe_site(const probe_site&) = delete;
+            probe_site& operator=(const probe_site&) = delete;
+
+            void record(std::uint64_t elements, std::uint64_t allocations, std::uint64_t ns) noexcept {
+                calls_.fetch_add(1, std::memory_order_relaxed);
+                elements_.fetch_add(elements, std::memory_order_relaxed);
+                allocations_.fetch_add(allocations, std::memory_order_relaxed);
+                total_ns_.fetch_add(ns, std::memory_order_relaxed);
+                histogram_[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            function_stats stats() const {
+                function_stats stats;
+                stats.name = name_;
+                stats.calls = calls_.load(std::memory_order_relaxed);
+                stats.elements = elements_.load(std::memory_order_relaxed);
+                stats.allocations = allocations_.load(std::memory_order_relaxed);
+                stats.total_ns = total_ns_.load(std::memory_order_relaxed);
+                for (std::size_t i = 0; i < time_buckets; ++i) {
+                    stats.time_histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+                }
+                return stats;
+            }
+
+            void reset() noexcept {
+                calls_ = 0;
+                elements_ = 0;
+                allocations_ = 0;
+                total_ns_ = 0;
+                for (auto& count : histogram_) {
+                    count = 0;
+                }
+            }
+
+            static std::size_t bucket(std::uint64_t ns) noexcept {
+                std::size_t i = 0;
+                while (ns > 1 && i + 1 < time_buckets) {
+                    ns >>= 1;
+                    ++i;
+                }
+                return i;
+            }
+
+        private:
+            const char* name_;
+            std::atomic<std::uint64_t> calls_{0};
+            std::atomic<std::uint64_t> elements_{0};
+            std::atomic<std::uint64_t> allocations_{0};
+            std::atomic<std::uint64_t> total_ns_{0};
+            std::array<std::atomic<std::uint64_t>, time_buckets> histogram_{};
+        };
+
+        // every template instantiation of a function has its own site, the snapshot sums them up by name
+        inline std::vector<function_stats> registry::snapshot() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<function_stats> stats;
+            for (auto site : sites_) {
+                auto current = site->stats();
+                auto same = std::find_if(stats.begin(), stats.end(), [&current](const function_stats& s) {
+                    return s.name == current.name;
+                });
+                if (same == stats.end()) {
+                    stats.push_back(std::move(current));
+                    continue;
+                }
+                same->calls += current.calls;
+                same->elements += current.elements;
+                same->allocations += current.allocations;
+                same->total_ns += current.total_ns;
+                std::transform(same->time_histogram.begin(), same->time_histogram.end(), current.time_histogram.begin(),
+                               same->time_histogram.begin(), std::plus<>());
+            }
+            return stats;
+        }
+
+        inline void registry::reset() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::for_each(sites_.begin(), sites_.end(), [](probe_site* site) { site->reset(); });
+        }
+
+        // records one call to the probe site when it goes out of scope
+        class scoped_probe {
+        public:
+            using clock_type = std::chrono::steady_clock;
+
+            scoped_probe(probe_site& site, std::uint64_t elements) noexcept
+                    : site_(site), elements_(elements), allocations_(detail::thread_allocations()),
+                      start_(clock_type::now()) {}
+
+            scoped_probe(const scoped_probe&) = delete;
+            scoped_probe& operator=(const scoped_probe&) = delete;
+
+            ~scoped_probe() {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start_).count();
+                site_.record(elements_, detail::thread_allocations() - allocations_, static_cast<std::uint64_t>(ns));
+            }
+
+        private:
+            probe_site& site_;
+            std::uint64_t elements_;
+            std::uint64_t allocations_;
+            clock_type::time_point start_;
+        };
+
+        inline std::vector<function_stats> snapshot() {
+            return registry::instance().snapshot();
+        }
+
+        inline void reset() {
+            registry::instance().reset();
+        }
+
+        // one line per function that was called at least once
+        inline std::string to_text(const std::vector<function_stats>& stats) {
+            std::ostringstream out;
+            for (auto& s : stats) {
+                if (s.calls == 0) {
+                    continue;
+                }
+                out << s.name << ": calls=" << s.calls << " elements=" << s.elements
+                    << " allocations=" << s.allocations << " total_ns=" << s.total_ns
+                    << " mean_ns=" << s.total_ns / s.calls << " histogram_log2_ns=[";
+                for (std::size_t i = 0; i < time_buckets; ++i) {
+                    out << (i == 0 ? "" : ",") << s.time_histogram[i];
+                }
+                out << "]\n";
+            }
+            return out.str();
+        }
+
+        inline std::string to_json(const std::vector<function_stats>& stats) {
+            std::ostringstream out;
+            out << "{";
+            auto first = true;
+            for (auto& s : stats) {
+                if (s.calls == 0) {
+                    continue;
+                }
+                out << (first ? "" : ",") << "\"" << s.name << "\":{\"calls\":" << s.calls
+                    << ",\"elements\":" << s.elements << ",\"allocations\":" << s.allocations
+                    << ",\"total_ns\":" << s.total_ns << ",\"histogram_log2_ns\":[";
+                for (std::size_t i = 0; i < time_buckets; ++i) {
+                    out << (i == 0 ? "" : ",") << s.time_histogram[i];
+                }
+                out << "]}";
+                first = false;
+            }
+            out << "}";
+            return out.str();
+        }
+    }
+}
+
+namespace saxion {
+    namespace instrumentation {
+        namespace detail {
+
+            // The allocators behind SAXION_ALGOS_DEFINE_ALLOCATION_HOOKS: every form of operator new counts
+            // the allocation and gets its memory from std::malloc, every form of operator delete gives it back
+            // with std::free. Over-aligned blocks are carved out of a larger malloc block that keeps its start
+            // right in front of the aligned pointer, so they pair with std::free too.
+
+            // returns nullptr if there is no memory
+            inline void* counted_allocate(std::size_t size) noexcept {
+                ++thread_allocations();
+                return std::malloc(size == 0 ? 1 : size);
+            }
+
+            inline void* counted_allocate(std::size_t size, std::align_val_t alignment) noexcept {
+                auto align = static_cast<std::size_t>(alignment);
+                auto block = counted_allocate(size + align + sizeof(void*));
+                if (block == nullptr) {
+                    return nullptr;
+                }
+                auto aligned = (reinterpret_cast<std::uintptr_t>(block) + sizeof(void*) + align - 1) & ~(std::uintptr_t{align} - 1);
+                reinterpret_cast<void**>(aligned)[-1] = block;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            inline void deallocate(void* p) noexcept {
+                std::free(p);
+            }
+
+            inline void deallocate(void* p, std::align_val_t) noexcept {
+                if (p != nullptr) {
+                    std::free(static_cast<void**>(p)[-1]);
+                }
+            }
+
+            // throws std::bad_alloc if there is no memory
+            template <typename... _Align>
+            void* counted_allocate_or_throw(std::size_t size, _Align... alignment) {
+                if (auto p = counted_allocate(size, alignment...)) {
+                    return p;
+                }
+                throw std::bad_alloc();
+            }
+        }
+    }
+}
+
+#ifdef SAXION_ALGOS_INSTRUMENT
+
+// Replaces all the replaceable forms of the global operator new and operator delete, so that every allocation
+// is counted and is released by the deallocator that matches its allocator.
+#define SAXION_ALGOS_DEFINE_ALLOCATION_HOOKS                                                                          \
+    void* operator new(std::size_t size) {                                                                            \
+        return ::saxion::instrumentation::detail::counted_allocate_or_throw(size);                                    \
+    }                                                                                                                 \
+    void* operator new[](std::size_t size) {                                                                          \
+        return ::saxion::instrumentation::detail::counted_allocate_or_throw(size);                                    \
+    }                                                                                                                 \
+    void* operator new(std::size_t size, const std::nothrow_t&) noexcept {                                            \
+        return ::saxion::instrumentation::detail::counted_allocate(size);                                             \
+    }                                                                                                                 \
+    void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {                                          \
+        return ::saxion::instrumentation::detail::counted_allocate(size);                                             \
+    }                                                                                                                 \
+    void* operator new(std::size_t size, std::align_val_t alignment) {                                                \
+        return ::saxion::instrumentation::detail::counted_allocate_or_throw(size, alignment);                         \
+    }                                                                                                                 \
+    void* operator new[](std::size_t size, std::align_val_t alignment) {                                              \
+        return ::saxion::instrumentation::detail::counted_allocate_or_throw(size, alignment);                         \
+    }                                                                                                                 \
+    void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {                \
+        return ::saxion::instrumentation::detail::counted_allocate(size, alignment);                                  \
+    }                                                                                                                 \
+    void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {              \
+        return ::saxion::instrumentation::detail::counted_allocate(size, alignment);                                  \
+    }                                                                                                                 \
+    void operator delete(void* p) noexcept { ::saxion::instrumentation::detail::deallocate(p); }                      \
+    void operator delete[](void* p) noexcept { ::saxion::instrumentation::detail::deallocate(p); }                    \
+    void operator delete(void* p, const std::nothrow_t&) noexcept { ::saxion::instrumentation::detail::deallocate(p); } \
+    void operator delete[](void* p, const std::nothrow_t&) noexcept { ::saxion::instrumentation::detail::deallocate(p); } \
+    void operator delete(void* p, std::size_t) noexcept { ::saxion::instrumentation::detail::deallocate(p); }         \
+    void operator delete[](void* p, std::size_t) noexcept { ::saxion::instrumentation::detail::deallocate(p); }       \
+    void operator delete(void* p, std::align_val_t alignment) noexcept {                                              \
+        ::saxion::instrumentation::detail::deallocate(p, alignment);                                                  \
+    }                                                                                                                 \
+    void operator delete[](void* p, std::align_val_t alignment) noexcept {                                            \
+        ::saxion::instrumentation::detail::deallocate(p, alignment);                                                  \
+    }                                                                                                                 \
+    void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept {                       \
+        ::saxion::instrumentation::detail::deallocate(p, alignment);                                                  \
+    }                                                                                                                 \
+    void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept {                     \
+        ::saxion::instrumentation::detail::deallocate(p, alignment);                                                  \
+    }                                                                                                                 \
+    void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {                                 \
+        ::saxion::instrumentation::detail::deallocate(p, alignment);                                                  \
+    }                                                                                                                 \
+    void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept {                               \
+        ::saxion::instrumentation::detail::deallocate(p, alignment);                                                  \
+    }
+
+#define SAXION_ALGOS_PROBE(name, elements)                                            \
+    static ::saxion::instrumentation::probe_site probe_site_(#name);                  \
+    ::saxion::instrumentation::scoped_probe probe_(probe_site_, static_cast<std::uint64_t>(elements))
+
+namespace saxion {
+
+    // saxion::algos with every member call recorded by the instrumentation
+    struct instrumented_algos {
+        template<typename _Iter>
+        auto has_all_tasks_assigned(_Iter begin, _Iter end) const {
+            SAXION_ALGOS_PROBE(has_all_tasks_assigned, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.has_all_tasks_assigned(begin, end);
+        }
+
+        template <typename _Iter>
+        bool has_task_with_deadline_afer(_Iter begin, _Iter end, const task::time_type& deadline) const {
+            SAXION_ALGOS_PROBE(has_task_with_deadline_afer, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.has_task_with_deadline_afer(begin, end, deadline);
+        }
+
+        template <typename _Iter>
+        auto remove_asignee_from_all(_Iter begin, _Iter end, const std::string& person) const {
+            SAXION_ALGOS_PROBE(remove_asignee_from_all, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.remove_asignee_from_all(begin, end, person);
+        }
+
+        template <typename _Iter>
+        auto extend_deadlines(_Iter begin, _Iter end, int priority, const task::time_difference_type& extension) const {
+            SAXION_ALGOS_PROBE(extend_deadlines, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.extend_deadlines(begin, end, priority, extension);
+        }
+
+        template <typename _Iter>
+        auto count_tasks_with_deadlines_before(_Iter begin, _Iter end, const task::time_type& deadline) const {
+            SAXION_ALGOS_PROBE(count_tasks_with_deadlines_before, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.count_tasks_with_deadlines_before(begin, end, deadline);
+        }
+
+        template <typename _Iter>
+        bool add_assignee_to_task(_Iter begin, _Iter end, int id, std::string person) const {
+            SAXION_ALGOS_PROBE(add_assignee_to_task, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.add_assignee_to_task(begin, end, id, std::move(person));
+        }
+
+        template <typename _Iter>
+        std::vector<task> get_tasks_with_priority(_Iter begin, _Iter end, int priority) const {
+            SAXION_ALGOS_PROBE(get_tasks_with_priority, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.get_tasks_with_priority(begin, end, priority);
+        }
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter get_tasks_with_priority(_Iter begin, _Iter end, int priority, _OutIter out) const {
+            SAXION_ALGOS_PROBE(get_tasks_with_priority, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.get_tasks_with_priority(begin, end, priority, out);
+        }
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter get_task_indices_with_priority(_Iter begin, _Iter end, int priority, _OutIter out) const {
+            SAXION_ALGOS_PROBE(get_task_indices_with_priority, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.get_task_indices_with_priority(begin, end, priority, out);
+        }
+
+        template <typename _Iter, typename _OutIter>
+        _Iter extract_tasks_with_deadline_before(_Iter begin, _Iter end,  _OutIter out, const task::time_type& deadline) const {
+            SAXION_ALGOS_PROBE(extract_tasks_with_deadline_before, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.extract_tasks_with_deadline_before(begin, end, out, deadline);
+        }
+
+        template <typename _Iter>
+        std::vector<algos::id_prio> list_sorted_by_prio(_Iter begin, _Iter end) const {
+            SAXION_ALGOS_PROBE(list_sorted_by_prio, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.list_sorted_by_prio(begin, end);
+        }
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter list_sorted_by_prio(_Iter begin, _Iter end, _OutIter out) const {
+            SAXION_ALGOS_PROBE(list_sorted_by_prio, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.list_sorted_by_prio(begin, end, out);
+        }
+
+        template <typename _Cont>
+        auto remove_all_finished(_Cont& container) const {
+            SAXION_ALGOS_PROBE(remove_all_finished, container.size());
+            return algos_.remove_all_finished(container);
+        }
+
+        template <typename _Iter>
+        task& get_nth_to_complete(_Iter begin, _Iter end, int n) const {
+            SAXION_ALGOS_PROBE(get_nth_to_complete, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.get_nth_to_complete(begin, end, n);
+        }
+
+        template <typename _Iter>
+        std::vector<task> get_first_n_to_complete(_Iter begin, _Iter end, int n) const {
+            SAXION_ALGOS_PROBE(get_first_n_to_complete, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.get_first_n_to_complete(begin, end, n);
+        }
+
+        template <typename _Iter, typename _OutIter>
+        _OutIter get_first_n_to_complete(_Iter begin, _Iter end, int n, _OutIter out) const {
+            SAXION_ALGOS_PROBE(get_first_n_to_complete, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.get_first_n_to_complete(begin, end, n, out);
+        }
+
+        template <typename _Iter, typename _OIter>
+        void cost_burndown(_Iter begin, _Iter end, _OIter obegin) const {
+            SAXION_ALGOS_PROBE(cost_burndown, ::saxion::instrumentation::detail::range_elements(begin, end));
+            algos_.cost_burndown(begin, end, obegin);
+        }
+
+        template <typename _Iter>
+        std::pair<task, task> cheapest_and_most_expensive(_Iter begin, _Iter end) const {
+            SAXION_ALGOS_PROBE(cheapest_and_most_expensive, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.cheapest_and_most_expensive(begin, end);
+        }
+
+        template <typename _Iter>
+        std::pair<_Iter, _Iter> find_cheapest_and_most_expensive(_Iter begin, _Iter end) const {
+            SAXION_ALGOS_PROBE(find_cheapest_and_most_expensive, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.find_cheapest_and_most_expensive(begin, end);
+        }
+
+        template <typename _Iter>
+        auto total_cost(_Iter begin, _Iter end) const {
+            SAXION_ALGOS_PROBE(total_cost, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.total_cost(begin, end);
+        }
+
+        template <typename _Iter>
+        double total_cost_of(_Iter begin, _Iter end, const std::string& assignee) const {
+            SAXION_ALGOS_PROBE(total_cost_of, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.total_cost_of(begin, end, assignee);
+        }
+
+        template <typename _Iter>
+        _Iter separate_by_deadline(_Iter begin, _Iter end, const task::time_type& deadline) const {
+            SAXION_ALGOS_PROBE(separate_by_deadline, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.separate_by_deadline(begin, end, deadline);
+        }
+
+        template <typename _Iter>
+        double estimate_workload(_Iter begin, _Iter end, const std::string& person) const {
+            SAXION_ALGOS_PROBE(estimate_workload, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.estimate_workload(begin, end, person);
+        }
+
+        template <typename _Iter>
+        auto average_cost_of_prio(_Iter begin ,_Iter end, int priority) const {
+            SAXION_ALGOS_PROBE(average_cost_of_prio, ::saxion::instrumentation::detail::range_elements(begin, end));
+            return algos_.average_cost_of_prio(begin, end, priority);
+        }
+
+    private:
+        algos algos_;
+    };
+}
+
+#else
+
+#define SAXION_ALGOS_DEFINE_ALLOCATION_HOOKS
+
+#define SAXION_ALGOS_PROBE(name, elements) ((void)0)
+
+namespace saxion {
+    using instrumented_algos = algos;
+}
+
+#endif
+
+#endif //ALGOS_INSTRUMENTATION_H
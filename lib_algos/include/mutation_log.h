@@ -0,0 +1,482 @@
+#ifndef ALGOS_MUTATION_LOG_H
+#define ALGOS_MUTATION_LOG_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "algos.h"
+#include "binary_format.h"
+#include "task.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace saxion {
+
+    // One change to a task collection, as recorded in the mutation log.
+    // apply() is deterministic: remove_all_finished carries its own "now", so replaying it later removes the same tasks.
+    struct mutation {
+        enum class kind : std::uint8_t {
+            add_task = 1,
+            extend_deadlines,
+            add_assignee_to_task,
+            remove_asignee_from_all,
+            remove_all_finished
+        };
+
+        explicit mutation(kind what) : what(what) {}
+
+        kind what;
+        task added{};
+        int priority = 0;
+        int id = 0;
+        std::string person;
+        task::time_difference_type extension{};
+        task::time_type cutoff;
+
+        static mutation add_task(task t) {
+            mutation m{kind::add_task};
+            m.added = std::move(t);
+            return m;
+        }
+
+        static mutation extend_deadlines(int priority, const task::time_difference_type& extension) {
+            mutation m{kind::extend_deadlines};
+            m.priority = priority;
+            m.extension = extension;
+            return m;
+        }
+
+        static mutation add_assignee_to_task(int id, std::string person) {
+            mutation m{kind::add_assignee_to_task};
+            m.id = id;
+            m.person = std::move(person);
+            return m;
+        }
+
+        static mutation remove_asignee_from_all(std::string person) {
+            mutation m{kind::remove_asignee_from_all};
+            m.person = std::move(person);
+            return m;
+        }
+
+        // removes the tasks with deadlines on or before <now>
+        static mutation remove_all_finished(const task::time_type& now) {
+            mutation m{kind::remove_all_finished};
+            m.cutoff = now;
+            return m;
+        }
+
+        // returns false if apply() wouldn't change <tasks>
+        bool changes(const std::vector<task>& tasks) const {
+            switch (what) {
+                case kind::add_assignee_to_task: {
+                    auto t = std::find_if(tasks.begin(), tasks.end(), [this](const task& t) { return t.id == id; });
+                    return t != tasks.end() && t->assignees.count(person) == 0;
+                }
+                case kind::remove_all_finished:
+                    return std::any_of(tasks.begin(), tasks.end(), [this](const task& t) { return t.deadline <= cutoff; });
+                default:
+                    return true;
+            }
+        }
+
+        // returns false if the mutation didn't change anything
+        bool apply(std::vector<task>& tasks) const {
+            switch (what) {
+                case kind::add_task:
+                    tasks.push_back(added);
+                    return true;
+                case kind::extend_deadlines:
+                    algos().extend_deadlines(tasks.begin(), tasks.end(), priority, extension);
+                    return true;
+                case kind::add_assignee_to_task: {
+                    auto t = std::find_if(tasks.begin(), tasks.end(), [this](const task& t) { return t.id == id; });
+                    return t != tasks.end() && t->assignees.insert(person).second;
+                }
+                case kind::remove_asignee_from_all:
+                    algos().remove_asignee_from_all(tasks.begin(), tasks.end(), person);
+                    return true;
+                case kind::remove_all_finished: {
+                    auto size = tasks.size();
+                    tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [this](const task& t) {
+                        return t.deadline <= cutoff;
+                    }), tasks.end());
+                    return tasks.size() != size;
+                }
+            }
+            return false;
+        }
+
+        void encode(binary::writer& out) const {
+            out.u8(static_cast<std::uint8_t>(what));
+            switch (what) {
+                case kind::add_task:
+                    out.encode(added);
+                    break;
+                case kind::extend_deadlines:
+                    out.i32(priority);
+                    out.duration(extension);
+                    break;
+                case kind::add_assignee_to_task:
+                    out.i32(id);
+                    out.str(person);
+                    break;
+                case kind::remove_asignee_from_all:
+                    out.str(person);
+                    break;
+                case kind::remove_all_finished:
+                    out.time(cutoff);
+                    break;
+            }
+        }
+
+        static mutation decode(binary::reader& in) {
+            auto what = static_cast<kind>(in.u8());
+            switch (what) {
+                case kind::add_task:
+                    return add_task(in.decode());
+                case kind::extend_deadlines: {
+                    auto priority = in.i32();
+                    return extend_deadlines(priority, in.duration());
+                }
+                case kind::add_assignee_to_task: {
+                    auto id = in.i32();
+                    return add_assignee_to_task(id, in.str());
+                }
+                case kind::remove_asignee_from_all:
+                    return remove_asignee_from_all(in.str());
+                case kind::remove_all_finished:
+                    return remove_all_finished(in.time());
+            }
+            throw binary::format_error("unknown mutation kind");
+        }
+    };
+
+    struct log_options {
+        // a group of buffered records is written (and synced) once it reaches either of these sizes
+        std::size_t group_bytes = 1 << 16;
+        std::size_t group_records = 256;
+        // a snapshot is taken (and the log emptied) once that many records were logged since the last one, 0 = never.
+        // It's taken inline by the mutation that fills the group: that call writes and syncs every task
+        // instead of one record, so leave it at 0 and call snapshot() off the hot path where latency matters
+        std::uint64_t snapshot_every = 0;
+        // fsync the log and the snapshots, where the platform supports it
+        bool sync = true;
+    };
+
+    // An append-only file of checksummed mutation records, written in groups:
+    //   u32 payload size | u32 crc32 of the payload | payload: u64 sequence number, encoded mutation
+    class mutation_log {
+    public:
+        mutation_log(std::filesystem::path path, const log_options& options)
+                : path_(std::move(path)), options_(options), file_(std::fopen(path_.string().c_str(), "ab")) {
+            if (file_ == nullptr) {
+                throw std::system_error(errno, std::generic_category(), "cannot open " + path_.string());
+            }
+        }
+
+        mutation_log(const mutation_log&) = delete;
+        mutation_log& operator=(const mutation_log&) = delete;
+
+        ~mutation_log() {
+            try {
+                flush();
+            } catch (...) {
+                // nothing sensible to do about it in a destructor
+            }
+            if (file_ != nullptr) {
+                std::fclose(file_);
+            }
+        }
+
+        // buffers a record, the group is written once it's full; returns true if it was written.
+        // If writing the group throws, the record is dropped from it again (the earlier ones stay buffered)
+        bool append(std::uint64_t sequence, const mutation& m) {
+            auto start = pending_.size();
+            binary::writer out(pending_);
+            out.u32(0);
+            out.u32(0);
+            out.u64(sequence);
+            m.encode(out);
+
+            auto size = static_cast<std::uint32_t>(pending_.size() - start - 8);
+            auto crc = binary::crc32(pending_.data() + start + 8, size);
+            for (auto i = 0; i < 4; ++i) {
+                pending_[start + i] = static_cast<char>((size >> (8 * i)) & 0xff);
+                pending_[start + 4 + i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+            }
+
+            if (++pending_records_ >= options_.group_records || pending_.size() >= options_.group_bytes) {
+                try {
+                    flush();
+                } catch (...) {
+                    pending_.resize(start);
+                    --pending_records_;
+                    throw;
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // writes and syncs the buffered records
+        void flush() {
+            if (pending_.empty()) {
+                return;
+            }
+            if (file_ == nullptr) {
+                throw std::system_error(EBADF, std::generic_category(), "the log was closed after an error: " + path_.string());
+            }
+            if (std::fwrite(pending_.data(), 1, pending_.size(), file_) != pending_.size()) {
+                throw std::system_error(errno, std::generic_category(), "cannot write " + path_.string());
+            }
+            sync(file_, options_.sync);
+            pending_.clear();
+            pending_records_ = 0;
+        }
+
+        // drops all the records, once they are covered by a snapshot; if the log cannot be truncated it is
+        // closed (freopen closes it even when it fails), the next clear() tries to open it again
+        void clear() {
+            pending_.clear();
+            pending_records_ = 0;
+            file_ = file_ != nullptr ? std::freopen(path_.string().c_str(), "wb", file_) : std::fopen(path_.string().c_str(), "wb");
+            if (file_ == nullptr) {
+                throw std::system_error(errno, std::generic_category(), "cannot truncate " + path_.string());
+            }
+            sync(file_, options_.sync);
+        }
+
+        // calls fn(sequence, mutation) for every intact record of the log at <path>;
+        // a torn or corrupt tail (an interrupted group) is cut off the file. Returns the number of records read.
+        template <typename _Fn>
+        static std::size_t replay(const std::filesystem::path& path, _Fn fn) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                return 0;
+            }
+            std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            in.close();
+
+            std::size_t position = 0, records = 0;
+            while (bytes.size() - position >= 8) {
+                binary::reader header(bytes.data() + position, 8);
+                auto size = header.u32();
+                auto crc = header.u32();
+                if (size > bytes.size() - position - 8 || binary::crc32(bytes.data() + position + 8, size) != crc) {
+                    break;
+                }
+                binary::reader payload(bytes.data() + position + 8, size);
+                auto sequence = payload.u64();
+                fn(sequence, mutation::decode(payload));
+                position += 8 + size;
+                ++records;
+            }
+
+            if (position != bytes.size()) {
+                std::filesystem::resize_file(path, position);
+            }
+            return records;
+        }
+
+        // flushes <file> and, if <to_disk>, fsyncs it; throws std::system_error if either fails
+        static void sync(std::FILE* file, bool to_disk) {
+            if (std::fflush(file) != 0) {
+                throw std::system_error(errno, std::generic_category(), "cannot flush the log");
+            }
+#if defined(__unix__) || defined(__APPLE__)
+            if (to_disk && ::fsync(::fileno(file)) != 0) {
+                throw std::system_error(errno, std::generic_category(), "cannot sync the log");
+            }
+#else
+            (void)to_disk;
+#endif
+        }
+
+        // fsyncs <directory>, so that the files created or renamed in it survive a crash
+        static void sync_directory(const std::filesystem::path& directory, bool to_disk) {
+#if defined(__unix__) || defined(__APPLE__)
+            if (!to_disk) {
+                return;
+            }
+            auto fd = ::open(directory.string().c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "cannot open " + directory.string());
+            }
+            auto result = ::fsync(fd);
+            auto error = errno;
+            ::close(fd);
+            if (result != 0) {
+                throw std::system_error(error, std::generic_category(), "cannot sync " + directory.string());
+            }
+#else
+            (void)directory;
+            (void)to_disk;
+#endif
+        }
+
+    private:
+        std::filesystem::path path_;
+        log_options options_;
+        std::FILE* file_;
+        std::vector<char> pending_;
+        std::size_t pending_records_ = 0;
+    };
+
+    // A task collection whose mutations are logged to <directory> before they are acknowledged,
+    // so that it can be recovered after a restart from the last snapshot plus the tail of the log.
+    // Mutations become durable once their group is written: when it fills up, on commit() or on destruction.
+    class logged_task_store {
+    public:
+        explicit logged_task_store(const std::filesystem::path& directory, const log_options& options = {})
+                : options_(options), snapshot_path_(directory / "tasks.snapshot") {
+            std::filesystem::create_directories(directory);
+            load_snapshot();
+            replayed_ = mutation_log::replay(directory / "tasks.log", [this](std::uint64_t sequence, const mutation& m) {
+                if (sequence > snapshot_sequence_) {
+                    m.apply(tasks_);
+                    sequence_ = sequence;
+                }
+            });
+            log_ = std::make_unique<mutation_log>(directory / "tasks.log", options_);
+        }
+
+        const std::vector<task>& tasks() const noexcept {
+            return tasks_;
+        }
+
+        // the sequence number of the last logged mutation
+        std::uint64_t sequence() const noexcept {
+            return sequence_;
+        }
+
+        // the number of log records read during recovery
+        std::size_t replayed() const noexcept {
+            return replayed_;
+        }
+
+        void add_task(task t) {
+            record(mutation::add_task(std::move(t)));
+        }
+
+        void extend_deadlines(int priority, const task::time_difference_type& extension) {
+            record(mutation::extend_deadlines(priority, extension));
+        }
+
+        bool add_assignee_to_task(int id, std::string person) {
+            return record(mutation::add_assignee_to_task(id, std::move(person)));
+        }
+
+        void remove_asignee_from_all(std::string person) {
+            record(mutation::remove_asignee_from_all(std::move(person)));
+        }
+
+        void remove_all_finished(const task::time_type& now = task::clock_type::now()) {
+            record(mutation::remove_all_finished(now));
+        }
+
+        // writes the buffered group of mutations
+        void commit() {
+            log_->flush();
+        }
+
+        // writes all the tasks to a new snapshot and empties the log
+        void snapshot() {
+            log_->flush();
+
+            std::vector<char> bytes;
+            binary::writer out(bytes);
+            bytes.insert(bytes.end(), magic, magic + sizeof magic - 1);
+            out.u64(sequence_);
+            out.u64(tasks_.size());
+            std::for_each(tasks_.begin(), tasks_.end(), [&out](const task& t) { out.encode(t); });
+            out.u32(binary::crc32(bytes.data(), bytes.size()));
+
+            auto temporary = snapshot_path_;
+            temporary += ".tmp";
+            {
+                auto file = std::fopen(temporary.string().c_str(), "wb");
+                if (file == nullptr) {
+                    throw std::system_error(errno, std::generic_category(), "cannot write " + temporary.string());
+                }
+                try {
+                    if (std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+                        throw std::system_error(errno, std::generic_category(), "cannot write " + temporary.string());
+                    }
+                    mutation_log::sync(file, options_.sync);
+                } catch (...) {
+                    std::fclose(file);
+                    throw;
+                }
+                std::fclose(file);
+            }
+            std::filesystem::rename(temporary, snapshot_path_);
+            mutation_log::sync_directory(snapshot_path_.parent_path(), options_.sync);
+
+            snapshot_sequence_ = sequence_;
+            log_->clear();
+        }
+
+    private:
+        static constexpr char magic[] = "ALGOSNP1";
+
+        // logs the mutation before applying it, so a mutation that cannot be logged leaves the tasks as they were
+        bool record(const mutation& m) {
+            if (!m.changes(tasks_)) {
+                return false;
+            }
+            auto written = log_->append(sequence_ + 1, m);
+            ++sequence_;
+            m.apply(tasks_);
+            if (written && options_.snapshot_every != 0 && sequence_ - snapshot_sequence_ >= options_.snapshot_every) {
+                snapshot();
+            }
+            return true;
+        }
+
+        void load_snapshot() {
+            std::ifstream in(snapshot_path_, std::ios::binary);
+            if (!in) {
+                return;
+            }
+            std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            auto header = sizeof magic - 1;
+            if (bytes.size() < header + 20 || !std::equal(magic, magic + header, bytes.begin())) {
+                throw binary::format_error("not a task snapshot: " + snapshot_path_.string());
+            }
+            binary::reader crc(bytes.data() + bytes.size() - 4, 4);
+            if (binary::crc32(bytes.data(), bytes.size() - 4) != crc.u32()) {
+                throw binary::format_error("corrupt task snapshot: " + snapshot_path_.string());
+            }
+
+            binary::reader body(bytes.data() + header, bytes.size() - header - 4);
+            snapshot_sequence_ = sequence_ = body.u64();
+            auto count = body.u64();
+            tasks_.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i) {
+                tasks_.push_back(body.decode());
+            }
+        }
+
+        log_options options_;
+        std::filesystem::path snapshot_path_;
+        std::vector<task> tasks_;
+        std::unique_ptr<mutation_log> log_;
+        std::uint64_t sequence_ = 0;
+        std::uint64_t snapshot_sequence_ = 0;
+        std::size_t replayed_ = 0;
+    };
+}
+
+#endif //ALGOS_MUTATION_LOG_H
@@ -0,0 +1,130 @@
+#ifndef ALGOS_NAME_AGGREGATION_H
+#define ALGOS_NAME_AGGREGATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "parallel.h"
+#include "task.h"
+
+namespace saxion {
+
+    // the tasks that share a name
+    struct name_group {
+        std::string name;
+        std::size_t count = 0;
+        double total_cost = 0.0;
+        task::time_type earliest_deadline = task::time_type::max();
+        task::time_type latest_deadline = task::time_type::min();
+        // the union of the assignees of the tasks
+        std::set<std::string> assignees;
+    };
+
+    namespace detail {
+
+        // An open addressing (linear probing) hash table from name to name_group. The slots hold indexes
+        // into the groups, which stay in order of insertion; the hash of each group is kept next to it, so
+        // probing compares hashes before names and growing the table doesn't hash the names again.
+        class name_table {
+        public:
+            name_table() : slots_(16, empty) {}
+
+            void add(const task& t) {
+                auto& g = find_or_insert(t.name, std::hash<std::string>()(t.name));
+                ++g.count;
+                g.total_cost += t.cost;
+                g.earliest_deadline = std::min(g.earliest_deadline, t.deadline);
+                g.latest_deadline = std::max(g.latest_deadline, t.deadline);
+                g.assignees.insert(t.assignees.begin(), t.assignees.end());
+            }
+
+            // adds the groups of <other>; the new names come after the ones already here, in their order in <other>
+            void merge(name_table&& other) {
+                for (std::size_t i = 0; i < other.groups_.size(); ++i) {
+                    auto& from = other.groups_[i];
+                    auto& g = find_or_insert(from.name, other.hashes_[i]);
+                    g.count += from.count;
+                    g.total_cost += from.total_cost;
+                    g.earliest_deadline = std::min(g.earliest_deadline, from.earliest_deadline);
+                    g.latest_deadline = std::max(g.latest_deadline, from.latest_deadline);
+                    g.assignees.merge(from.assignees);
+                }
+            }
+
+            std::vector<name_group> release() && {
+                return std::move(groups_);
+            }
+
+        private:
+            static constexpr std::uint32_t empty = ~std::uint32_t{0};
+
+            name_group& find_or_insert(const std::string& name, std::size_t hash) {
+                auto mask = slots_.size() - 1;
+                for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+                    auto index = slots_[slot];
+                    if (index == empty) {
+                        slots_[slot] = static_cast<std::uint32_t>(groups_.size());
+                        hashes_.push_back(hash);
+                        groups_.push_back(name_group{name, 0, 0.0, task::time_type::max(), task::time_type::min(), {}});
+                        grow_if_full();
+                        return groups_.back();
+                    }
+                    if (hashes_[index] == hash && groups_[index].name == name) {
+                        return groups_[index];
+                    }
+                }
+            }
+
+            // keeps the load factor at most 1/2
+            void grow_if_full() {
+                if (2 * groups_.size() <= slots_.size()) {
+                    return;
+                }
+                slots_.assign(2 * slots_.size(), empty);
+                auto mask = slots_.size() - 1;
+                for (std::size_t index = 0; index < hashes_.size(); ++index) {
+                    auto slot = hashes_[index] & mask;
+                    while (slots_[slot] != empty) {
+                        slot = (slot + 1) & mask;
+                    }
+                    slots_[slot] = static_cast<std::uint32_t>(index);
+                }
+            }
+
+            std::vector<std::uint32_t> slots_;
+            std::vector<std::size_t> hashes_;
+            std::vector<name_group> groups_;
+        };
+    }
+
+    // Groups tasks by name in one pass over the range, without copying or reordering the tasks
+    // (instead of sorting copies of them with task::name_comparator): every thread aggregates a chunk of
+    // the range into its own hash table, the tables are merged in chunk order at the end.
+    struct name_aggregation {
+        // the minimal number of tasks a thread aggregates
+        static constexpr std::size_t grain = 1 << 14;
+
+        // returns the groups in order of the first appearance of their names in the range;
+        // ranges that aren't random access are aggregated on the calling thread
+        template <typename _Iter>
+        std::vector<name_group> group_by_name(_Iter begin, _Iter end, unsigned threads = detail::default_thread_count()) const {
+            std::vector<detail::name_table> tables(detail::range_chunk_count(begin, end, threads, grain));
+            detail::parallel_ranges(begin, end, threads, grain, [&tables](std::size_t chunk, _Iter first, _Iter last) {
+                detail::name_table table;
+                std::for_each(first, last, [&table](const task& t) { table.add(t); });
+                tables[chunk] = std::move(table);
+            });
+            for (std::size_t chunk = 1; chunk < tables.size(); ++chunk) {
+                tables[0].merge(std::move(tables[chunk]));
+            }
+            return std::move(tables[0]).release();
+        }
+    };
+}
+
+#endif //ALGOS_NAME_AGGREGATION_H
@@ -0,0 +1,103 @@
+#ifndef ALGOS_PARALLEL_H
+#define ALGOS_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace saxion {
+
+    namespace detail {
+
+        template <typename _Iter>
+        constexpr bool is_random_access_v = std::is_base_of_v<std::random_access_iterator_tag,
+                typename std::iterator_traits<_Iter>::iterator_category>;
+
+        // the number of threads used by the parallel kernels when the caller doesn't ask for a specific count
+        inline unsigned default_thread_count() noexcept {
+            auto n = std::thread::hardware_concurrency();
+            return n == 0 ? 1u : n;
+        }
+
+        // the number of chunks parallel_chunks() will split <size> elements into
+        inline std::size_t chunk_count(std::size_t size, unsigned threads, std::size_t grain) noexcept {
+            if (threads == 0) {
+                threads = default_thread_count();
+            }
+            if (grain == 0) {
+                grain = 1;
+            }
+            auto by_grain = (size + grain - 1) / grain;
+            auto chunks = by_grain < threads ? by_grain : threads;
+            return chunks == 0 ? 1 : chunks;
+        }
+
+        // splits the index range [0, size) into chunk_count() contiguous chunks and calls fn(chunk, first, last)
+        // for each of them, one thread per chunk (the calling thread takes chunk 0).
+        // An exception thrown by any chunk is rethrown on the calling thread once all the chunks are done.
+        // returns the number of chunks
+        template <typename _Fn>
+        std::size_t parallel_chunks(std::size_t size, unsigned threads, std::size_t grain, _Fn&& fn) {
+            auto chunks = chunk_count(size, threads, grain);
+            auto bounds = [size, chunks](std::size_t c) { return size / chunks * c + std::min(c, size % chunks); };
+
+            std::vector<std::exception_ptr> errors(chunks);
+            auto run = [&](std::size_t c) {
+                try {
+                    fn(c, bounds(c), bounds(c + 1));
+                } catch (...) {
+                    errors[c] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(chunks - 1);
+            for (std::size_t c = 1; c < chunks; ++c) {
+                workers.emplace_back(run, c);
+            }
+            run(0);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            for (auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+            return chunks;
+        }
+
+        // the number of chunks parallel_ranges() will split [begin, end) into
+        template <typename _Iter>
+        std::size_t range_chunk_count(_Iter begin, _Iter end, unsigned threads, std::size_t grain) noexcept {
+            if constexpr (is_random_access_v<_Iter>) {
+                return chunk_count(static_cast<std::size_t>(end - begin), threads, grain);
+            } else {
+                (void)begin; (void)end; (void)threads; (void)grain;
+                return 1;
+            }
+        }
+
+        // runs fn(chunk, first, last) over the iterator range [begin, end) split into chunks;
+        // ranges that aren't random access are processed as a single chunk on the calling thread
+        template <typename _Iter, typename _Fn>
+        std::size_t parallel_ranges(_Iter begin, _Iter end, unsigned threads, std::size_t grain, _Fn&& fn) {
+            if constexpr (is_random_access_v<_Iter>) {
+                return parallel_chunks(static_cast<std::size_t>(end - begin), threads, grain,
+                                       [&](std::size_t c, std::size_t first, std::size_t last) {
+                                           fn(c, begin + first, begin + last);
+                                       });
+            } else {
+                fn(std::size_t{0}, begin, end);
+                return 1;
+            }
+        }
+    }
+}
+
+#endif //ALGOS_PARALLEL_H
@@ -0,0 +1,184 @@
+#ifndef ALGOS_QUERY_CACHE_H
+#define ALGOS_QUERY_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "algos.h"
+#include "task.h"
+
+namespace saxion {
+
+    // A vector of tasks with a version that is bumped by every mutation, so results computed from it
+    // can be reused for as long as the version is the same.
+    class versioned_tasks {
+    public:
+        versioned_tasks() = default;
+
+        explicit versioned_tasks(std::vector<task> tasks) : tasks_(std::move(tasks)) {}
+
+        const std::vector<task>& tasks() const noexcept {
+            return tasks_;
+        }
+
+        std::uint64_t version() const noexcept {
+            return version_;
+        }
+
+        void insert(task t) {
+            tasks_.push_back(std::move(t));
+            ++version_;
+        }
+
+        void extend_deadlines(int priority, const task::time_difference_type& extension) {
+            algos().extend_deadlines(tasks_.begin(), tasks_.end(), priority, extension);
+            ++version_;
+        }
+
+        // the version is only bumped if the person was added
+        bool add_assignee_to_task(int id, std::string person) {
+            auto t = std::find_if(tasks_.begin(), tasks_.end(), [id](const task& t) { return t.id == id; });
+            if (t == tasks_.end() || !t->assignees.insert(std::move(person)).second) {
+                return false;
+            }
+            ++version_;
+            return true;
+        }
+
+        void remove_asignee_from_all(const std::string& person) {
+            algos().remove_asignee_from_all(tasks_.begin(), tasks_.end(), person);
+            ++version_;
+        }
+
+        // removes the tasks with deadlines on or before <now>, returns how many; the version is only bumped if there were any
+        std::size_t remove_all_finished(const task::time_type& now = task::clock_type::now()) {
+            auto size = tasks_.size();
+            tasks_.erase(std::remove_if(tasks_.begin(), tasks_.end(), [&now](const task& t) { return t.deadline <= now; }),
+                         tasks_.end());
+            if (tasks_.size() != size) {
+                ++version_;
+            }
+            return size - tasks_.size();
+        }
+
+        // any other change: calls fn(std::vector<task>&) and bumps the version
+        template <typename _Fn>
+        decltype(auto) modify(_Fn fn) {
+            ++version_;
+            return fn(tasks_);
+        }
+
+    private:
+        // runs the read-only algos functions, some of which take non-const iterators
+        friend class cached_queries;
+
+        std::vector<task> tasks_;
+        std::uint64_t version_ = 0;
+    };
+
+    struct cache_stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        // entries dropped because the tasks changed since they were computed
+        std::uint64_t invalidations = 0;
+
+        double hit_rate() const noexcept {
+            return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
+    };
+
+    // Memoizes the aggregate algos queries on a versioned_tasks, keyed by (function, arguments, version):
+    // a repeated query on unchanged tasks is answered without looking at the tasks again.
+    // Entries of older versions are dropped on the first miss after a mutation.
+    class cached_queries {
+    public:
+        explicit cached_queries(versioned_tasks& tasks) : tasks_(tasks) {}
+
+        // same as algos::total_cost
+        double total_cost() {
+            return std::get<double>(memo(function::total_cost, 0, [](std::vector<task>& tasks) {
+                return result(static_cast<double>(algos().total_cost(tasks.begin(), tasks.end())));
+            }));
+        }
+
+        // same as algos::average_cost_of_prio
+        double average_cost_of_prio(int priority) {
+            return std::get<double>(memo(function::average_cost_of_prio, priority, [priority](std::vector<task>& tasks) {
+                return result(static_cast<double>(algos().average_cost_of_prio(tasks.begin(), tasks.end(), priority)));
+            }));
+        }
+
+        // same as algos::cost_burndown, computed on a copy of the tasks as it may reorder them
+        std::vector<double> cost_burndown() {
+            return std::get<std::vector<double>>(memo(function::cost_burndown, 0, [](std::vector<task>& tasks) {
+                auto copy = tasks;
+                std::vector<double> burndown;
+                algos().cost_burndown(copy.begin(), copy.end(), std::back_inserter(burndown));
+                return result(std::move(burndown));
+            }));
+        }
+
+        // same as algos::cheapest_and_most_expensive, the tasks must not be empty
+        std::pair<task, task> cheapest_and_most_expensive() {
+            return std::get<std::pair<task, task>>(memo(function::cheapest_and_most_expensive, 0, [](std::vector<task>& tasks) {
+                return result(algos().cheapest_and_most_expensive(tasks.begin(), tasks.end()));
+            }));
+        }
+
+        const cache_stats& stats() const noexcept {
+            return stats_;
+        }
+
+        std::size_t size() const noexcept {
+            return entries_.size();
+        }
+
+        void clear() noexcept {
+            entries_.clear();
+        }
+
+    private:
+        enum class function {
+            total_cost,
+            average_cost_of_prio,
+            cost_burndown,
+            cheapest_and_most_expensive
+        };
+
+        using key = std::tuple<function, std::int64_t, std::uint64_t>;
+        using result = std::variant<double, std::vector<double>, std::pair<task, task>>;
+
+        template <typename _Compute>
+        const result& memo(function f, std::int64_t argument, _Compute compute) {
+            auto version = tasks_.version();
+            auto it = entries_.find(key(f, argument, version));
+            if (it != entries_.end()) {
+                ++stats_.hits;
+                return it->second;
+            }
+
+            ++stats_.misses;
+            for (auto e = entries_.begin(); e != entries_.end();) {
+                if (std::get<2>(e->first) != version) {
+                    e = entries_.erase(e);
+                    ++stats_.invalidations;
+                } else {
+                    ++e;
+                }
+            }
+            return entries_.emplace(key(f, argument, version), compute(tasks_.tasks_)).first->second;
+        }
+
+        versioned_tasks& tasks_;
+        std::map<key, result> entries_;
+        cache_stats stats_;
+    };
+}
+
+#endif //ALGOS_QUERY_CACHE_H
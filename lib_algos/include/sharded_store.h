@@ -0,0 +1,262 @@
+#ifndef ALGOS_SHARDED_STORE_H
+#define ALGOS_SHARDED_STORE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algos.h"
+#include "parallel.h"
+#include "task.h"
+
+namespace saxion {
+
+    // A task collection partitioned by a hash of task::id into shards that share nothing.
+    // Every shard owns its tasks and a worker thread; all the work on a shard is done by its worker,
+    // in the order it was posted, so writes to different shards scale across cores without any locking of the tasks.
+    // Queries are scattered to all the shards and their partial results are gathered and merged on the calling thread.
+    class sharded_task_store {
+    public:
+        explicit sharded_task_store(unsigned shards = detail::default_thread_count()) {
+            auto count = std::max(shards, 1u);
+            shards_.reserve(count);
+            for (unsigned s = 0; s < count; ++s) {
+                shards_.push_back(std::make_unique<shard>());
+            }
+        }
+
+        std::size_t shard_count() const noexcept {
+            return shards_.size();
+        }
+
+        // the shard that owns the task with <id>
+        std::size_t shard_of(int id) const noexcept {
+            // Fibonacci hashing, so that consecutive ids are spread over all the shards
+            auto h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9e3779b97f4a7c15ull;
+            return static_cast<std::size_t>((h >> 32) % shards_.size());
+        }
+
+        // queues the insertion of <t>, it is visible to all the queries posted after it
+        void insert(task t) {
+            shards_[shard_of(t.id)]->post([t = std::move(t)](std::vector<task>& tasks) mutable {
+                tasks.push_back(std::move(t));
+            });
+        }
+
+        // queues the insertion of copies of the tasks in [begin, end), one batch per shard
+        template <typename _Iter>
+        void insert(_Iter begin, _Iter end) {
+            std::vector<std::vector<task>> batches(shards_.size());
+            std::for_each(begin, end, [&](const task& t) { batches[shard_of(t.id)].push_back(t); });
+            for (std::size_t s = 0; s < shards_.size(); ++s) {
+                if (!batches[s].empty()) {
+                    shards_[s]->post([batch = std::move(batches[s])](std::vector<task>& tasks) mutable {
+                        tasks.insert(tasks.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+                    });
+                }
+            }
+        }
+
+        // waits until all the queued writes are applied, rethrows the first exception any of them threw
+        void flush() {
+            gather([](const std::vector<task>&) { return 0; });
+            for (auto& s : shards_) {
+                s->rethrow();
+            }
+        }
+
+        // the number of tasks in each shard
+        std::vector<std::size_t> shard_sizes() const {
+            return gather([](const std::vector<task>& tasks) { return tasks.size(); });
+        }
+
+        std::size_t size() const {
+            auto sizes = shard_sizes();
+            return std::accumulate(sizes.begin(), sizes.end(), std::size_t{0});
+        }
+
+        // same as algos::total_cost over all the tasks
+        double total_cost() const {
+            auto partial = gather([](const std::vector<task>& tasks) { return algos().total_cost(tasks.begin(), tasks.end()); });
+            return std::accumulate(partial.begin(), partial.end(), 0.0);
+        }
+
+        // same as algos::count_tasks_with_deadlines_before over all the tasks
+        std::size_t count_tasks_with_deadlines_before(const task::time_type& deadline) const {
+            auto partial = gather([deadline](const std::vector<task>& tasks) {
+                return static_cast<std::size_t>(algos().count_tasks_with_deadlines_before(tasks.begin(), tasks.end(), deadline));
+            });
+            return std::accumulate(partial.begin(), partial.end(), std::size_t{0});
+        }
+
+        // same as algos::get_first_n_to_complete over all the tasks:
+        // every shard copies out its own first n, the overall first n are among those
+        std::vector<task> get_first_n_to_complete(int n) const {
+            auto partial = gather([n](const std::vector<task>& tasks) {
+                return algos().get_first_n_to_complete(tasks.begin(), tasks.end(), n);
+            });
+
+            std::vector<task> first;
+            for (auto& part : partial) {
+                auto middle = first.size();
+                first.insert(first.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+                std::inplace_merge(first.begin(), first.begin() + static_cast<std::ptrdiff_t>(middle), first.end(),
+                                   task::completion_comparator());
+            }
+            first.resize(std::min(first.size(), static_cast<std::size_t>(std::max(n, 0))));
+            return first;
+        }
+
+        // same as algos::cost_burndown over all the tasks:
+        // every shard sums its costs per deadline in deadline order, the sums of the shards are merged by deadline
+        template <typename _OIter>
+        void cost_burndown(_OIter obegin) const {
+            using point = std::pair<task::time_type, double>;
+            auto partial = gather([](const std::vector<task>& tasks) {
+                std::vector<point> points;
+                points.reserve(tasks.size());
+                std::transform(tasks.begin(), tasks.end(), std::back_inserter(points),
+                               [](const task& t) { return point(t.deadline, t.cost); });
+                std::sort(points.begin(), points.end(), [](const point& lhs, const point& rhs) { return lhs.first < rhs.first; });
+                return grouped(std::move(points));
+            });
+
+            std::vector<point> points;
+            for (auto& part : partial) {
+                auto middle = points.size();
+                points.insert(points.end(), part.begin(), part.end());
+                std::inplace_merge(points.begin(), points.begin() + static_cast<std::ptrdiff_t>(middle), points.end(),
+                                   [](const point& lhs, const point& rhs) { return lhs.first < rhs.first; });
+            }
+            points = grouped(std::move(points));
+
+            auto sum = 0.0;
+            std::transform(points.begin(), points.end(), obegin, [&sum](const point& p) { return sum += p.second; });
+        }
+
+        // runs fn(const std::vector<task>&) on every shard, on the shard's worker, and returns the results in shard order;
+        // the queries only read the shards, writes go through post()
+        template <typename _Fn>
+        auto gather(_Fn fn) const -> std::vector<std::invoke_result_t<_Fn&, const std::vector<task>&>> {
+            using result_type = std::invoke_result_t<_Fn&, const std::vector<task>&>;
+            std::vector<std::future<result_type>> futures;
+            futures.reserve(shards_.size());
+            for (auto& s : shards_) {
+                auto job = std::make_shared<std::packaged_task<result_type(const std::vector<task>&)>>(fn);
+                futures.push_back(job->get_future());
+                s->post([job](std::vector<task>& tasks) { (*job)(tasks); });
+            }
+
+            std::vector<result_type> results;
+            results.reserve(futures.size());
+            std::transform(futures.begin(), futures.end(), std::back_inserter(results),
+                           [](std::future<result_type>& f) { return f.get(); });
+            return results;
+        }
+
+    private:
+        // sums the costs of adjacent points with the same deadline
+        static std::vector<std::pair<task::time_type, double>> grouped(std::vector<std::pair<task::time_type, double>> points) {
+            if (points.empty()) {
+                return points;
+            }
+            auto last = points.begin();
+            std::for_each(std::next(points.begin()), points.end(), [&last](const std::pair<task::time_type, double>& p) {
+                if (p.first == last->first) {
+                    last->second += p.second;
+                } else {
+                    *++last = p;
+                }
+            });
+            points.erase(std::next(last), points.end());
+            return points;
+        }
+
+        class shard {
+        public:
+            using job = std::function<void(std::vector<task>&)>;
+
+            shard() : worker_([this] { work(); }) {}
+
+            shard(const shard&) = delete;
+            shard& operator=(const shard&) = delete;
+
+            // the worker finishes the queued jobs before it stops
+            ~shard() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                ready_.notify_one();
+                worker_.join();
+            }
+
+            void post(job j) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    mailbox_.push_back(std::move(j));
+                }
+                ready_.notify_one();
+            }
+
+            void rethrow() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (error_) {
+                    auto error = error_;
+                    error_ = nullptr;
+                    std::rethrow_exception(error);
+                }
+            }
+
+        private:
+            void work() {
+                std::deque<job> jobs;
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        ready_.wait(lock, [this] { return stopping_ || !mailbox_.empty(); });
+                        if (mailbox_.empty()) {
+                            return;
+                        }
+                        jobs.swap(mailbox_);
+                    }
+                    // the whole mailbox is taken at once, so a batch of writes costs one lock
+                    for (; !jobs.empty(); jobs.pop_front()) {
+                        try {
+                            jobs.front()(tasks_);
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(mutex_);
+                            if (!error_) {
+                                error_ = std::current_exception();
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::vector<task> tasks_;
+            std::mutex mutex_;
+            std::condition_variable ready_;
+            std::deque<job> mailbox_;
+            std::exception_ptr error_;
+            bool stopping_ = false;
+            // started last, once everything it uses is constructed
+            std::thread worker_;
+        };
+
+        std::vector<std::unique_ptr<shard>> shards_;
+    };
+}
+
+#endif //ALGOS_SHARDED_STORE_H
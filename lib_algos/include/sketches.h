@@ -0,0 +1,326 @@
+#ifndef ALGOS_SKETCHES_H
+#define ALGOS_SKETCHES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "parallel.h"
+#include "task.h"
+
+namespace saxion {
+
+    // KLL quantile sketch: summarizes a stream of doubles in O(k log(n / k)) memory,
+    // rank queries are off by about normalized_rank_error() * count() with high probability.
+    // Sketches of disjoint streams can be merged, the result has the same error bound.
+    class quantile_sketch {
+    public:
+        static constexpr unsigned default_seed = 0x5eed;
+
+        explicit quantile_sketch(std::size_t k = 200, unsigned seed = default_seed) : k_(std::max<std::size_t>(k, 8)), random_(seed) {
+            levels_.emplace_back();
+        }
+
+        void update(double value) {
+            if (std::isnan(value)) {
+                return;
+            }
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+            ++count_;
+            levels_.front().push_back(value);
+            if (levels_.front().size() >= capacity(0)) {
+                compress();
+            }
+        }
+
+        void merge(const quantile_sketch& other) {
+            if (other.count_ == 0) {
+                return;
+            }
+            while (levels_.size() < other.levels_.size()) {
+                levels_.emplace_back();
+            }
+            for (std::size_t h = 0; h < other.levels_.size(); ++h) {
+                levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+            }
+            count_ += other.count_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+            compress();
+        }
+
+        std::uint64_t count() const noexcept {
+            return count_;
+        }
+
+        // the approximate value with rank q * count(), q in [0, 1]; NaN for an empty sketch
+        double quantile(double q) const {
+            if (count_ == 0) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            if (q <= 0.0) {
+                return min_;
+            }
+            if (q >= 1.0) {
+                return max_;
+            }
+            auto items = weighted();
+            auto target = q * static_cast<double>(count_);
+            std::uint64_t rank = 0;
+            for (auto& [value, weight] : items) {
+                rank += weight;
+                if (static_cast<double>(rank) >= target) {
+                    return value;
+                }
+            }
+            return max_;
+        }
+
+        // the approximate fraction of the values that are smaller than <value>
+        double rank(double value) const {
+            if (count_ == 0) {
+                return 0.0;
+            }
+            std::uint64_t below = 0;
+            for (std::size_t h = 0; h < levels_.size(); ++h) {
+                below += static_cast<std::uint64_t>(std::count_if(levels_[h].begin(), levels_[h].end(),
+                                                                  [value](double v) { return v < value; })) << h;
+            }
+            return static_cast<double>(below) / static_cast<double>(count_);
+        }
+
+        // the rank error bound (as a fraction of count()) of the KLL paper for this k, holds with ~99% probability
+        double normalized_rank_error() const noexcept {
+            return 2.296 / std::pow(static_cast<double>(k_), 0.9723);
+        }
+
+        // true if every level is below its capacity, as update() and merge() leave the sketch
+        bool compacted() const noexcept {
+            for (std::size_t h = 0; h < levels_.size(); ++h) {
+                if (levels_[h].size() >= capacity(h)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // the number of values the sketch retains
+        std::size_t retained() const noexcept {
+            std::size_t size = 0;
+            for (auto& level : levels_) {
+                size += level.size();
+            }
+            return size;
+        }
+
+    private:
+        // higher levels hold more weight and get bigger compactors, the top one gets k
+        std::size_t capacity(std::size_t h) const {
+            auto depth = levels_.size() - 1 - h;
+            auto c = static_cast<double>(k_) * std::pow(2.0 / 3.0, static_cast<double>(depth));
+            return std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(c)));
+        }
+
+        // halves the lowest full level into the next one (keeping every other item, starting at a random one)
+        // until every level fits its capacity
+        void compress() {
+            // a new top level shrinks the capacities of all the levels below it, so those are checked again
+            for (auto compacted = true; compacted;) {
+                compacted = false;
+                for (std::size_t h = 0; h < levels_.size(); ++h) {
+                    if (levels_[h].size() < capacity(h)) {
+                        continue;
+                    }
+                    if (h + 1 == levels_.size()) {
+                        levels_.emplace_back();
+                    }
+                    auto& level = levels_[h];
+                    std::sort(level.begin(), level.end());
+                    // an odd item out stays at this level
+                    auto paired = level.size() - level.size() % 2;
+                    auto kept = paired == level.size() ? std::vector<double>{} : std::vector<double>{level.back()};
+                    auto& next = levels_[h + 1];
+                    for (auto i = static_cast<std::size_t>(random_() & 1u); i < paired; i += 2) {
+                        next.push_back(level[i]);
+                    }
+                    level = std::move(kept);
+                    compacted = true;
+                }
+            }
+        }
+
+        std::vector<std::pair<double, std::uint64_t>> weighted() const {
+            std::vector<std::pair<double, std::uint64_t>> items;
+            items.reserve(retained());
+            for (std::size_t h = 0; h < levels_.size(); ++h) {
+                std::transform(levels_[h].begin(), levels_[h].end(), std::back_inserter(items),
+                               [h](double v) { return std::make_pair(v, std::uint64_t{1} << h); });
+            }
+            std::sort(items.begin(), items.end());
+            return items;
+        }
+
+        std::size_t k_;
+        std::minstd_rand random_;
+        std::vector<std::vector<double>> levels_;
+        std::uint64_t count_ = 0;
+        double min_ = std::numeric_limits<double>::infinity();
+        double max_ = -std::numeric_limits<double>::infinity();
+    };
+
+    // HyperLogLog distinct counter with 2^precision one byte registers,
+    // the relative standard error of estimate() is about 1.04 / sqrt(2^precision).
+    // Counters with the same precision can be merged, merging another precision throws std::invalid_argument.
+    class distinct_counter {
+    public:
+        explicit distinct_counter(unsigned precision = 12)
+                : precision_(std::clamp(precision, 4u, 18u)), registers_(std::size_t{1} << precision_, 0) {}
+
+        void add(const std::string& value) noexcept {
+            add_hash(hash(value));
+        }
+
+        void add_hash(std::uint64_t h) noexcept {
+            auto index = static_cast<std::size_t>(h >> (64 - precision_));
+            auto rest = (h << precision_) | (std::uint64_t{1} << (precision_ - 1));
+            auto rank = static_cast<std::uint8_t>(leading_zeros(rest) + 1);
+            registers_[index] = std::max(registers_[index], rank);
+        }
+
+        // throws std::invalid_argument if <other> has another precision
+        void merge(const distinct_counter& other) {
+            if (registers_.size() != other.registers_.size()) {
+                throw std::invalid_argument("distinct_counter: can't merge counters with different precisions");
+            }
+            std::transform(registers_.begin(), registers_.end(), other.registers_.begin(), registers_.begin(),
+                           [](std::uint8_t lhs, std::uint8_t rhs) { return std::max(lhs, rhs); });
+        }
+
+        double estimate() const {
+            auto m = static_cast<double>(registers_.size());
+            auto sum = 0.0;
+            std::size_t zeros = 0;
+            for (auto r : registers_) {
+                sum += std::ldexp(1.0, -static_cast<int>(r));
+                zeros += r == 0 ? 1 : 0;
+            }
+            auto alpha = 0.7213 / (1.0 + 1.079 / m);
+            auto raw = alpha * m * m / sum;
+            // linear counting is more accurate while many registers are still empty
+            if (raw <= 2.5 * m && zeros > 0) {
+                return m * std::log(m / static_cast<double>(zeros));
+            }
+            return raw;
+        }
+
+        double relative_error() const noexcept {
+            return 1.04 / std::sqrt(static_cast<double>(registers_.size()));
+        }
+
+        unsigned precision() const noexcept {
+            return precision_;
+        }
+
+        // FNV-1a followed by the murmur3 finalizer, stable across runs and platforms
+        static std::uint64_t hash(const std::string& value) noexcept {
+            std::uint64_t h = 14695981039346656037ull;
+            for (auto c : value) {
+                h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+            }
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+    private:
+        static unsigned leading_zeros(std::uint64_t x) noexcept {
+            unsigned n = 0;
+            for (auto bit = std::uint64_t{1} << 63; bit != 0 && (x & bit) == 0; bit >>= 1) {
+                ++n;
+            }
+            return n;
+        }
+
+        unsigned precision_;
+        std::vector<std::uint8_t> registers_;
+    };
+
+    // builds the sketches in one pass over a range of tasks, split between threads and merged at the end
+    struct sketches {
+        // the minimal number of tasks a thread works on
+        static constexpr std::size_t grain = 1 << 14;
+
+        template <typename _Iter>
+        quantile_sketch cost_quantiles(_Iter begin, _Iter end, std::size_t k = 200,
+                                       unsigned threads = detail::default_thread_count()) const {
+            std::vector<quantile_sketch> partial;
+            for (std::size_t c = 0; c < detail::range_chunk_count(begin, end, threads, grain); ++c) {
+                partial.emplace_back(k, chunk_seed(c));
+            }
+            detail::parallel_ranges(begin, end, threads, grain, [&](std::size_t c, _Iter first, _Iter last) {
+                std::for_each(first, last, [&sketch = partial[c]](const task& t) { sketch.update(t.cost); });
+            });
+            return merged(partial, quantile_sketch(k));
+        }
+
+        // one cost quantile sketch per priority
+        template <typename _Iter>
+        std::map<int, quantile_sketch> cost_quantiles_by_priority(_Iter begin, _Iter end, std::size_t k = 200,
+                                                                  unsigned threads = detail::default_thread_count()) const {
+            std::vector<std::map<int, quantile_sketch>> partial(detail::range_chunk_count(begin, end, threads, grain));
+            detail::parallel_ranges(begin, end, threads, grain, [&](std::size_t c, _Iter first, _Iter last) {
+                std::for_each(first, last, [&sketches = partial[c], k, c](const task& t) {
+                    sketches.try_emplace(t.priority, k, chunk_seed(c)).first->second.update(t.cost);
+                });
+            });
+
+            std::map<int, quantile_sketch> result;
+            for (auto& sketches : partial) {
+                for (auto& [priority, sketch] : sketches) {
+                    result.try_emplace(priority, k).first->second.merge(sketch);
+                }
+            }
+            return result;
+        }
+
+        template <typename _Iter>
+        distinct_counter distinct_assignees(_Iter begin, _Iter end, unsigned precision = 12,
+                                            unsigned threads = detail::default_thread_count()) const {
+            std::vector<distinct_counter> partial(detail::range_chunk_count(begin, end, threads, grain), distinct_counter(precision));
+            detail::parallel_ranges(begin, end, threads, grain, [&](std::size_t c, _Iter first, _Iter last) {
+                std::for_each(first, last, [&counter = partial[c]](const task& t) {
+                    std::for_each(t.assignees.begin(), t.assignees.end(), [&counter](const std::string& name) {
+                        counter.add(name);
+                    });
+                });
+            });
+            return merged(partial, distinct_counter(precision));
+        }
+
+    private:
+        // every chunk gets its own seed: chunks that flipped the same coins when compacting would make correlated
+        // errors, which add up in the merged sketch instead of cancelling out
+        static unsigned chunk_seed(std::size_t chunk) noexcept {
+            return quantile_sketch::default_seed ^ static_cast<unsigned>((chunk + 1) * 0x9e3779b9u);
+        }
+
+        template <typename _Sketch>
+        static _Sketch merged(const std::vector<_Sketch>& partial, _Sketch result) {
+            std::for_each(partial.begin(), partial.end(), [&result](const _Sketch& sketch) { result.merge(sketch); });
+            return result;
+        }
+    };
+}
+
+#endif //ALGOS_SKETCHES_H
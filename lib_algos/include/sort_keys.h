@@ -0,0 +1,198 @@
+#ifndef ALGOS_SORT_KEYS_H
+#define ALGOS_SORT_KEYS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "parallel.h"
+#include "task.h"
+
+namespace saxion {
+
+    // a task reduced to its packed completion key and its position in the original range
+    struct keyed_task {
+        std::uint64_t key;
+        std::size_t index;
+    };
+
+    // Packs a task's deadline (with the one second resolution promised by task) and priority into one uint64
+    // that orders exactly like task::completion_comparator, so that ordering tasks by completion becomes
+    // an integer sort of a compact (key, index) array instead of a sort of the tasks themselves.
+    //
+    // layout: | 60 bits: deadline in seconds, biased to be unsigned | 4 bits: priority |
+    // Deadlines are floored to whole seconds; tasks whose deadlines differ by less than a second compare equal.
+    struct sort_keys {
+        static constexpr unsigned priority_bits = 4;
+        static constexpr std::uint64_t priority_mask = (std::uint64_t{1} << priority_bits) - 1;
+        static constexpr std::int64_t deadline_bias = std::int64_t{1} << 59;
+
+        // sorts smaller than that are done with std::sort, larger ones with the radix sort
+        static constexpr std::size_t radix_threshold = 1 << 14;
+        // the minimal number of keys a radix sort thread works on
+        static constexpr std::size_t radix_grain = 1 << 15;
+
+        static std::uint64_t pack(const task& t) noexcept {
+            auto seconds = std::chrono::floor<std::chrono::seconds>(t.deadline.time_since_epoch()).count();
+            seconds = std::clamp<std::int64_t>(seconds, -deadline_bias, deadline_bias - 1);
+            auto prio = std::clamp<std::int64_t>(t.priority, 0, priority_mask);
+            return (static_cast<std::uint64_t>(seconds + deadline_bias) << priority_bits)
+                   | static_cast<std::uint64_t>(prio);
+        }
+
+        static task::time_type deadline_of(std::uint64_t key) noexcept {
+            auto seconds = static_cast<std::int64_t>(key >> priority_bits) - deadline_bias;
+            return task::time_type(std::chrono::seconds(seconds));
+        }
+
+        static int priority_of(std::uint64_t key) noexcept {
+            return static_cast<int>(key & priority_mask);
+        }
+
+        // returns the (key, index) pairs of all the tasks in [begin, end), in the order of the range
+        template <typename _Iter>
+        std::vector<keyed_task> make(_Iter begin, _Iter end) const {
+            std::vector<keyed_task> keys;
+            if constexpr (detail::is_random_access_v<_Iter>) {
+                keys.reserve(static_cast<std::size_t>(end - begin));
+            }
+            std::size_t index = 0;
+            std::transform(begin, end, std::back_inserter(keys), [&index](const task& t) {
+                return keyed_task{pack(t), index++};
+            });
+            return keys;
+        }
+
+        // sorts the keys; keys that are equal end up ordered by their index
+        void sort(std::vector<keyed_task>& keys, unsigned threads = detail::default_thread_count()) const {
+            if (keys.size() < radix_threshold) {
+                std::sort(keys.begin(), keys.end(), [](const keyed_task& lhs, const keyed_task& rhs) {
+                    return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.index < rhs.index);
+                });
+                return;
+            }
+            radix_sort(keys, threads);
+        }
+
+        // the keys of [begin, end) sorted in the order of completion
+        template <typename _Iter>
+        std::vector<keyed_task> sorted(_Iter begin, _Iter end, unsigned threads = detail::default_thread_count()) const {
+            auto keys = make(begin, end);
+            sort(keys, threads);
+            return keys;
+        }
+
+        // same as algos::get_nth_to_complete, selecting on the keys instead of the tasks;
+        // throws std::out_of_range if there are no more than <n> tasks
+        template <typename _Iter>
+        auto& nth_to_complete(_Iter begin, _Iter end, std::size_t n) const {
+            auto keys = make(begin, end);
+            if (n >= keys.size()) {
+                throw std::out_of_range("nth_to_complete: n is not less than the number of tasks");
+            }
+            auto by_key = [](const keyed_task& lhs, const keyed_task& rhs) { return lhs.key < rhs.key; };
+            std::nth_element(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(n), keys.end(), by_key);
+            return *std::next(begin, static_cast<std::ptrdiff_t>(keys[n].index));
+        }
+
+        // writes copies of the first n tasks to complete, in the order of completion, to <out>
+        template <typename _Iter, typename _OutIter>
+        _OutIter first_n_to_complete(_Iter begin, _Iter end, std::size_t n, _OutIter out) const {
+            auto keys = make(begin, end);
+            n = std::min(n, keys.size());
+            auto middle = keys.begin() + static_cast<std::ptrdiff_t>(n);
+            std::partial_sort(keys.begin(), middle, keys.end(), [](const keyed_task& lhs, const keyed_task& rhs) {
+                return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.index < rhs.index);
+            });
+            return copy_indexed(begin, end, keys.begin(), middle, out);
+        }
+
+        // same as algos::cost_burndown; tasks whose deadlines fall in the same second contribute one data point
+        template <typename _Iter, typename _OIter>
+        void cost_burndown(_Iter begin, _Iter end, _OIter obegin, unsigned threads = detail::default_thread_count()) const {
+            std::vector<double> costs;
+            std::transform(begin, end, std::back_inserter(costs), [](const task& t) { return t.cost; });
+            auto keys = sorted(begin, end, threads);
+
+            auto sum = 0.0;
+            for (auto k = keys.begin(); k != keys.end();) {
+                auto seconds = k->key >> priority_bits;
+                for (; k != keys.end() && (k->key >> priority_bits) == seconds; ++k) {
+                    sum += costs[k->index];
+                }
+                *obegin++ = sum;
+            }
+        }
+
+    private:
+        // copies the tasks at the indexes in [kbegin, kend) from the range [begin, end) to out, in the order of the keys
+        template <typename _Iter, typename _KIter, typename _OutIter>
+        static _OutIter copy_indexed(_Iter begin, _Iter end, _KIter kbegin, _KIter kend, _OutIter out) {
+            if constexpr (detail::is_random_access_v<_Iter>) {
+                (void)end;
+                return std::transform(kbegin, kend, out, [begin](const keyed_task& k) -> const task& {
+                    return begin[static_cast<std::ptrdiff_t>(k.index)];
+                });
+            } else {
+                std::vector<const task*> tasks;
+                std::transform(begin, end, std::back_inserter(tasks), [](const task& t) { return &t; });
+                return std::transform(kbegin, kend, out, [&tasks](const keyed_task& k) -> const task& {
+                    return *tasks[k.index];
+                });
+            }
+        }
+
+        // parallel LSD radix sort on 8-bit digits; digits that are the same for all the keys are skipped
+        static void radix_sort(std::vector<keyed_task>& keys, unsigned threads) {
+            constexpr std::size_t radix = 256;
+
+            auto varying = std::uint64_t{0};
+            for (auto& k : keys) {
+                varying |= k.key ^ keys.front().key;
+            }
+
+            auto chunks = detail::chunk_count(keys.size(), threads, radix_grain);
+            std::vector<std::array<std::size_t, radix>> offsets(chunks);
+            std::vector<keyed_task> buffer(keys.size());
+
+            for (unsigned shift = 0; shift < 64; shift += 8) {
+                if (((varying >> shift) & 0xff) == 0) {
+                    continue;
+                }
+
+                detail::parallel_chunks(keys.size(), threads, radix_grain,
+                                        [&](std::size_t c, std::size_t first, std::size_t last) {
+                                            auto& count = offsets[c];
+                                            count.fill(0);
+                                            for (auto i = first; i < last; ++i) {
+                                                ++count[(keys[i].key >> shift) & 0xff];
+                                            }
+                                        });
+
+                // turn the per-chunk counts into the position each chunk writes its first key with a given digit
+                std::size_t position = 0;
+                for (std::size_t digit = 0; digit < radix; ++digit) {
+                    for (auto& chunk : offsets) {
+                        auto count = chunk[digit];
+                        chunk[digit] = position;
+                        position += count;
+                    }
+                }
+
+                detail::parallel_chunks(keys.size(), threads, radix_grain,
+                                        [&](std::size_t c, std::size_t first, std::size_t last) {
+                                            auto& position = offsets[c];
+                                            for (auto i = first; i < last; ++i) {
+                                                buffer[position[(keys[i].key >> shift) & 0xff]++] = keys[i];
+                                            }
+                                        });
+                keys.swap(buffer);
+            }
+        }
+    };
+}
+
+#endif //ALGOS_SORT_KEYS_H
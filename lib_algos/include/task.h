@@ -17,6 +17,7 @@ namespace saxion {
         struct id_compare;
         struct priority_compare;
         struct deadline_compare;
+        struct completion_compare;
     }
 
     struct task {
@@ -44,6 +45,7 @@ namespace saxion {
         using id_comparator  =  detail::id_compare;
         using priority_comparator = detail::priority_compare;
         using deadline_comparator = detail::deadline_compare;
+        using completion_comparator = detail::completion_compare;
 
 
         friend std::ostream& operator<<(std::ostream&, const task&);
@@ -74,16 +76,23 @@ namespace saxion {
                 return lhs.deadline < rhs.deadline;
             }
         };
+
+        // order of completion: by deadline, deadline ties resolved by priority
+        struct completion_compare {
+            constexpr bool operator()(const task& lhs, const task& rhs) const {
+                return lhs.deadline < rhs.deadline || (lhs.deadline == rhs.deadline && lhs.priority < rhs.priority);
+            }
+        };
     }
 
 
-    std::ostream& operator<<(std::ostream& out, const task& t){
+    inline std::ostream& operator<<(std::ostream& out, const task& t){
         return out << t.id << ": " << t.name << " | " << t.priority << " | " << t.cost;
     }
 }
 
 namespace std{
-    void swap(saxion::task& lhs, saxion::task& rhs) noexcept {
+    inline void swap(saxion::task& lhs, saxion::task& rhs) noexcept {
         lhs.swap(rhs);
     }
 }
@@ -0,0 +1,354 @@
+#ifndef ALGOS_TASK_EXPORTER_H
+#define ALGOS_TASK_EXPORTER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+#include "algos.h"
+#include "binary_format.h"
+#include "task.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define SAXION_EXPORTER_POSIX 1
+#else
+#define SAXION_EXPORTER_POSIX 0
+#endif
+
+namespace saxion {
+
+    enum class export_format {
+        // a header line, then one line per record; the assignees of a task are joined by ';'
+        csv,
+        // one JSON object (or number, for costs) per line
+        ndjson,
+        // the encoding of binary_format.h; id_prios as i32 id | i32 priority, costs as f64
+        binary
+    };
+
+    // Writes ranges of tasks, list_sorted_by_prio results and cost_burndown results to a file in bulk.
+    // The records are formatted with std::to_chars into one large reusable buffer that goes out with
+    // a single write(2) (fwrite where there is no POSIX) whenever it fills up, instead of formatting field
+    // by field through an std::ostream. Unlike operator<< it exports all the fields of a task; deadlines
+    // are written as nanoseconds since the epoch, costs in the shortest form that reads back the same double.
+    // The CSV header is written before the first record only: write a single kind of record per CSV file.
+    class task_exporter {
+    public:
+#if SAXION_EXPORTER_POSIX
+        using handle_type = int;
+#else
+        using handle_type = std::FILE*;
+#endif
+
+        static constexpr std::size_t default_buffer_bytes = std::size_t{1} << 20;
+
+        // creates (or truncates) the file at <path>, throws std::system_error if that fails
+        task_exporter(const std::filesystem::path& path, export_format format, std::size_t buffer_bytes = default_buffer_bytes)
+                : format_(format), buffer_bytes_(buffer_bytes), owned_(true) {
+#if SAXION_EXPORTER_POSIX
+            handle_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (handle_ < 0) {
+#else
+            handle_ = std::fopen(path.string().c_str(), "wb");
+            if (handle_ == nullptr) {
+#endif
+                throw std::system_error(errno, std::generic_category(), "cannot create " + path.string());
+            }
+            buffer_.reserve(buffer_bytes_ + slack);
+        }
+
+        // writes to an open file (e.g. STDOUT_FILENO) that the exporter does not close
+        task_exporter(handle_type handle, export_format format, std::size_t buffer_bytes = default_buffer_bytes)
+                : format_(format), buffer_bytes_(buffer_bytes), handle_(handle) {
+            buffer_.reserve(buffer_bytes_ + slack);
+        }
+
+        task_exporter(const task_exporter&) = delete;
+        task_exporter& operator=(const task_exporter&) = delete;
+
+        // flushes what is left; call flush() first to see the errors
+        ~task_exporter() {
+            try {
+                flush();
+            } catch (const std::system_error&) {
+            }
+            if (owned_) {
+#if SAXION_EXPORTER_POSIX
+                ::close(handle_);
+#else
+                std::fclose(handle_);
+#endif
+            }
+        }
+
+        // returns the number of tasks written
+        template <typename _Iter>
+        std::size_t write_tasks(_Iter begin, _Iter end) {
+            header("id,name,priority,cost,deadline,assignees\n");
+            std::size_t count = 0;
+            for (; begin != end; ++begin, ++count) {
+                const task& t = *begin;
+                switch (format_) {
+                    case export_format::csv:
+                        number(t.id);
+                        put(',');
+                        csv_string(t.name);
+                        put(',');
+                        number(t.priority);
+                        put(',');
+                        number(t.cost);
+                        put(',');
+                        number(deadline_ns(t));
+                        put(',');
+                        csv_assignees(t);
+                        put('\n');
+                        break;
+                    case export_format::ndjson:
+                        put("{\"id\":");
+                        number(t.id);
+                        put(",\"name\":");
+                        json_string(t.name);
+                        put(",\"priority\":");
+                        number(t.priority);
+                        put(",\"cost\":");
+                        json_number(t.cost);
+                        put(",\"deadline\":");
+                        number(deadline_ns(t));
+                        put(",\"assignees\":[");
+                        for (auto name = t.assignees.begin(); name != t.assignees.end(); ++name) {
+                            if (name != t.assignees.begin()) {
+                                put(',');
+                            }
+                            json_string(*name);
+                        }
+                        put("]}\n");
+                        break;
+                    case export_format::binary:
+                        binary::writer(buffer_).encode(t);
+                        break;
+                }
+                flush_if_full();
+            }
+            return count;
+        }
+
+        // the (id, priority) tuples of algos::list_sorted_by_prio, returns the number written
+        template <typename _Iter>
+        std::size_t write_id_prios(_Iter begin, _Iter end) {
+            header("id,priority\n");
+            std::size_t count = 0;
+            for (; begin != end; ++begin, ++count) {
+                const algos::id_prio& ip = *begin;
+                switch (format_) {
+                    case export_format::csv:
+                        number(std::get<0>(ip));
+                        put(',');
+                        number(std::get<1>(ip));
+                        put('\n');
+                        break;
+                    case export_format::ndjson:
+                        put("{\"id\":");
+                        number(std::get<0>(ip));
+                        put(",\"priority\":");
+                        number(std::get<1>(ip));
+                        put("}\n");
+                        break;
+                    case export_format::binary: {
+                        binary::writer out(buffer_);
+                        out.i32(std::get<0>(ip));
+                        out.i32(std::get<1>(ip));
+                        break;
+                    }
+                }
+                flush_if_full();
+            }
+            return count;
+        }
+
+        // the cumulative costs of algos::cost_burndown, returns the number written
+        template <typename _Iter>
+        std::size_t write_costs(_Iter begin, _Iter end) {
+            header("cost\n");
+            std::size_t count = 0;
+            for (; begin != end; ++begin, ++count) {
+                double cost = *begin;
+                switch (format_) {
+                    case export_format::csv:
+                        number(cost);
+                        put('\n');
+                        break;
+                    case export_format::ndjson:
+                        json_number(cost);
+                        put('\n');
+                        break;
+                    case export_format::binary:
+                        binary::writer(buffer_).f64(cost);
+                        break;
+                }
+                flush_if_full();
+            }
+            return count;
+        }
+
+        // writes out the buffer, throws std::system_error if that fails
+        void flush() {
+            std::size_t done = 0;
+            while (done < buffer_.size()) {
+#if SAXION_EXPORTER_POSIX
+                auto written = ::write(handle_, buffer_.data() + done, buffer_.size() - done);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "cannot write the export");
+                }
+                done += static_cast<std::size_t>(written);
+#else
+                auto written = std::fwrite(buffer_.data() + done, 1, buffer_.size() - done, handle_);
+                if (written == 0) {
+                    throw std::system_error(errno, std::generic_category(), "cannot write the export");
+                }
+                done += written;
+#endif
+            }
+            bytes_written_ += buffer_.size();
+            buffer_.clear();
+#if !SAXION_EXPORTER_POSIX
+            std::fflush(handle_);
+#endif
+        }
+
+        // the bytes written to the file so far, without what is still buffered
+        std::uint64_t bytes_written() const noexcept {
+            return bytes_written_;
+        }
+
+        export_format format() const noexcept {
+            return format_;
+        }
+
+    private:
+        // room for a record beyond buffer_bytes_, so a buffer that is not full yet rarely has to grow
+        static constexpr std::size_t slack = 4096;
+
+        static std::int64_t deadline_ns(const task& t) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t.deadline.time_since_epoch()).count();
+        }
+
+        void put(char c) {
+            buffer_.push_back(c);
+        }
+
+        template <std::size_t _N>
+        void put(const char (&s)[_N]) {
+            buffer_.insert(buffer_.end(), s, s + _N - 1);
+        }
+
+        template <typename _Number>
+        void number(_Number n) {
+            char digits[32];
+            auto result = std::to_chars(digits, digits + sizeof digits, n);
+            buffer_.insert(buffer_.end(), digits, result.ptr);
+        }
+
+        // JSON has no inf or nan
+        void json_number(double d) {
+            if (std::isfinite(d)) {
+                number(d);
+            } else {
+                put("null");
+            }
+        }
+
+        // quoted only if it has to be, with doubled quotes
+        void csv_string(const std::string& s) {
+            if (s.find_first_of(",\"\r\n") == std::string::npos) {
+                buffer_.insert(buffer_.end(), s.begin(), s.end());
+                return;
+            }
+            put('"');
+            for (auto c : s) {
+                if (c == '"') {
+                    put('"');
+                }
+                put(c);
+            }
+            put('"');
+        }
+
+        void csv_assignees(const task& t) {
+            if (std::none_of(t.assignees.begin(), t.assignees.end(), [](auto& name) { return name.find_first_of(",\"\r\n") != std::string::npos; })) {
+                for (auto name = t.assignees.begin(); name != t.assignees.end(); ++name) {
+                    if (name != t.assignees.begin()) {
+                        put(';');
+                    }
+                    buffer_.insert(buffer_.end(), name->begin(), name->end());
+                }
+                return;
+            }
+            std::string joined;
+            for (auto& name : t.assignees) {
+                if (!joined.empty()) {
+                    joined += ';';
+                }
+                joined += name;
+            }
+            csv_string(joined);
+        }
+
+        void json_string(const std::string& s) {
+            static constexpr char hex[] = "0123456789abcdef";
+            put('"');
+            for (auto c : s) {
+                auto u = static_cast<unsigned char>(c);
+                if (c == '"' || c == '\\') {
+                    put('\\');
+                    put(c);
+                } else if (u < 0x20) {
+                    put("\\u00");
+                    put(hex[u >> 4]);
+                    put(hex[u & 0xf]);
+                } else {
+                    put(c);
+                }
+            }
+            put('"');
+        }
+
+        template <std::size_t _N>
+        void header(const char (&line)[_N]) {
+            if (format_ == export_format::csv && !started_) {
+                put(line);
+            }
+            started_ = true;
+        }
+
+        void flush_if_full() {
+            if (buffer_.size() >= buffer_bytes_) {
+                flush();
+            }
+        }
+
+        export_format format_;
+        std::size_t buffer_bytes_;
+        bool owned_ = false;
+        bool started_ = false;
+        handle_type handle_;
+        std::vector<char> buffer_;
+        std::uint64_t bytes_written_ = 0;
+    };
+}
+
+#undef SAXION_EXPORTER_POSIX
+
+#endif //ALGOS_TASK_EXPORTER_H
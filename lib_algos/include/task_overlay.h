@@ -0,0 +1,173 @@
+#ifndef ALGOS_TASK_OVERLAY_H
+#define ALGOS_TASK_OVERLAY_H
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "task.h"
+
+namespace saxion {
+
+    // A copy-on-write what-if view of a task vector: the scenario changes are recorded as copies of only the
+    // tasks they touch (keyed by position), the base tasks are never copied nor changed. The base vector must
+    // outlive the overlay and must not change while it is used. Copying an overlay copies just its changes,
+    // so a scenario can be branched into several others.
+    //
+    // The iterators are read-only and bidirectional; they work with all the algos functions that neither
+    // reorder nor change the range (count_tasks_with_deadlines_before, total_cost, total_cost_of, ...),
+    // and with sort_keys::cost_burndown and first_n_to_complete. Use materialize() for the others.
+    class task_overlay {
+    public:
+        class const_iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = task;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const task*;
+            using reference = const task&;
+
+            const_iterator() = default;
+
+            reference operator*() const {
+                return next_ != overlay_->changes_.end() && next_->first == index_ ? next_->second : overlay_->base_[index_];
+            }
+
+            pointer operator->() const {
+                return &**this;
+            }
+
+            const_iterator& operator++() {
+                if (next_ != overlay_->changes_.end() && next_->first == index_) {
+                    ++next_;
+                }
+                ++index_;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
+
+            const_iterator& operator--() {
+                --index_;
+                if (next_ != overlay_->changes_.begin() && std::prev(next_)->first == index_) {
+                    --next_;
+                }
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                auto old = *this;
+                --*this;
+                return old;
+            }
+
+            // the position in the base vector
+            std::size_t index() const noexcept {
+                return index_;
+            }
+
+            friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+                return lhs.index_ == rhs.index_;
+            }
+
+            friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+                return lhs.index_ != rhs.index_;
+            }
+
+        private:
+            friend class task_overlay;
+
+            using change_iterator = std::map<std::size_t, task>::const_iterator;
+
+            const_iterator(const task_overlay* overlay, std::size_t index, change_iterator next)
+                    : overlay_(overlay), index_(index), next_(next) {}
+
+            const task_overlay* overlay_ = nullptr;
+            std::size_t index_ = 0;
+            // the first change at or after index_
+            change_iterator next_{};
+        };
+
+        using iterator = const_iterator;
+        using value_type = task;
+        using size_type = std::size_t;
+
+        explicit task_overlay(const std::vector<task>& base) : base_(base) {}
+
+        // same as algos::extend_deadlines
+        void extend_deadlines(int priority, const task::time_difference_type& extension) {
+            change_if([priority](const task& t) { return t.priority == priority; },
+                      [&extension](task& t) { t.deadline += extension; });
+        }
+
+        // same as algos::remove_asignee_from_all, only the tasks that have <person> assigned are copied
+        void remove_asignee_from_all(const std::string& person) {
+            change_if([&person](const task& t) { return t.assignees.count(person) != 0; },
+                      [&person](task& t) { t.assignees.erase(person); });
+        }
+
+        // any other change: calls fn(task&) on the copy of the tasks for which pred(const task&) is true
+        template <typename _Pred, typename _Fn>
+        void change_if(_Pred pred, _Fn fn) {
+            auto change = changes_.begin();
+            for (std::size_t index = 0; index < base_.size(); ++index) {
+                auto copied = change != changes_.end() && change->first == index;
+                if (pred(copied ? static_cast<const task&>(change->second) : base_[index])) {
+                    if (!copied) {
+                        change = changes_.emplace_hint(change, index, base_[index]);
+                        copied = true;
+                    }
+                    fn(change->second);
+                }
+                if (copied) {
+                    ++change;
+                }
+            }
+        }
+
+        const task& operator[](std::size_t index) const {
+            auto change = changes_.find(index);
+            return change != changes_.end() ? change->second : base_[index];
+        }
+
+        std::size_t size() const noexcept {
+            return base_.size();
+        }
+
+        bool empty() const noexcept {
+            return base_.empty();
+        }
+
+        // the number of tasks that were copied because the scenario changed them
+        std::size_t changed() const noexcept {
+            return changes_.size();
+        }
+
+        // back to the base tasks
+        void reset() noexcept {
+            changes_.clear();
+        }
+
+        // a deep copy of the scenario, for the algos functions that need to reorder or change the tasks
+        std::vector<task> materialize() const {
+            return std::vector<task>(begin(), end());
+        }
+
+        const_iterator begin() const { return const_iterator(this, 0, changes_.begin()); }
+        const_iterator end() const { return const_iterator(this, base_.size(), changes_.end()); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    private:
+        const std::vector<task>& base_;
+        std::map<std::size_t, task> changes_;
+    };
+}
+
+#endif //ALGOS_TASK_OVERLAY_H
@@ -0,0 +1,394 @@
+#ifndef ALGOS_TASK_SLAB_H
+#define ALGOS_TASK_SLAB_H
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "task.h"
+
+#if defined(_MSC_VER) && !defined(__GNUC__)
+#include <intrin.h>
+#endif
+
+namespace saxion {
+
+    // a reference to a task in a task_slab; it stays valid until the task is erased, also across compactions
+    struct slab_handle {
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;
+
+        friend bool operator==(const slab_handle& lhs, const slab_handle& rhs) {
+            return lhs.index == rhs.index && lhs.generation == rhs.generation;
+        }
+
+        friend bool operator!=(const slab_handle& lhs, const slab_handle& rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    // A task container with O(1) insert and erase that never moves the other tasks:
+    //  - tasks live in slots of fixed size chunks, erased slots become tombstones that are reused by later inserts;
+    //  - an occupancy bitmap per chunk lets the iterators skip the tombstones a word (64 slots) at a time;
+    //  - handles go through a table of keys with generation counters, so a handle of an erased task is detected
+    //    and compact() can move the tasks into the holes without invalidating any handle.
+    // The iterators are bidirectional: all the algos functions that don't reorder the range work on a slab,
+    // the ones that sort or partition it need random access (and would break the handles), use a copy for those.
+    class task_slab {
+    public:
+        static constexpr std::size_t chunk_size = 1024;
+
+        template <bool _Const>
+        class basic_iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = task;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<_Const, const task*, task*>;
+            using reference = std::conditional_t<_Const, const task&, task&>;
+            using slab_type = std::conditional_t<_Const, const task_slab, task_slab>;
+
+            basic_iterator() = default;
+
+            basic_iterator(slab_type* slab, std::size_t slot) : slab_(slab), slot_(slot) {}
+
+            // iterator to const_iterator
+            template <bool _OtherConst, typename = std::enable_if_t<_Const && !_OtherConst>>
+            basic_iterator(const basic_iterator<_OtherConst>& other) : slab_(other.slab_), slot_(other.slot_) {}
+
+            reference operator*() const { return slab_->slot(slot_); }
+            pointer operator->() const { return &slab_->slot(slot_); }
+
+            basic_iterator& operator++() {
+                slot_ = slab_->next_occupied(slot_ + 1);
+                return *this;
+            }
+
+            basic_iterator operator++(int) {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
+
+            basic_iterator& operator--() {
+                slot_ = slab_->previous_occupied(slot_);
+                return *this;
+            }
+
+            basic_iterator operator--(int) {
+                auto old = *this;
+                --*this;
+                return old;
+            }
+
+            friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) {
+                return lhs.slot_ == rhs.slot_;
+            }
+
+            friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) {
+                return lhs.slot_ != rhs.slot_;
+            }
+
+        private:
+            friend class task_slab;
+            friend class basic_iterator<!_Const>;
+
+            slab_type* slab_ = nullptr;
+            std::size_t slot_ = 0;
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using value_type = task;
+        using size_type = std::size_t;
+
+        task_slab() = default;
+
+        template <typename _Iter>
+        task_slab(_Iter begin, _Iter end) {
+            std::for_each(begin, end, [this](const task& t) { insert(t); });
+        }
+
+        task_slab(const task_slab&) = delete;
+        task_slab& operator=(const task_slab&) = delete;
+        task_slab(task_slab&&) = default;
+        task_slab& operator=(task_slab&&) = default;
+
+        slab_handle insert(task t) {
+            std::size_t slot;
+            if (!free_slots_.empty()) {
+                slot = free_slots_.back();
+                free_slots_.pop_back();
+            } else {
+                if (slots_ == chunks_.size() * chunk_size) {
+                    chunks_.push_back(std::make_unique<chunk>());
+                }
+                slot = slots_++;
+            }
+
+            std::uint32_t index;
+            if (!free_keys_.empty()) {
+                index = free_keys_.back();
+                free_keys_.pop_back();
+            } else {
+                index = static_cast<std::uint32_t>(keys_.size());
+                keys_.push_back(key{0, 0});
+            }
+            keys_[index].slot = static_cast<std::uint32_t>(slot);
+
+            occupy(slot, index, std::move(t));
+            ++size_;
+            return slab_handle{index, keys_[index].generation};
+        }
+
+        // returns false if the task was already erased; may compact the slab (see set_compaction_threshold)
+        bool erase(const slab_handle& h) {
+            if (!contains(h)) {
+                return false;
+            }
+            release(keys_[h.index].slot);
+            compact_if_sparse();
+            return true;
+        }
+
+        // erases the task at <it> and returns the iterator to the next one; never compacts
+        iterator erase(const_iterator it) {
+            release(it.slot_);
+            return iterator(this, next_occupied(it.slot_ + 1));
+        }
+
+        // erases the tasks for which pred(task) is true, returns the number of erased tasks
+        template <typename _Pred>
+        std::size_t erase_if(_Pred pred) {
+            std::size_t erased = 0;
+            for (auto it = cbegin(); it != cend();) {
+                if (pred(*it)) {
+                    it = erase(it);
+                    ++erased;
+                } else {
+                    ++it;
+                }
+            }
+            compact_if_sparse();
+            return erased;
+        }
+
+        bool contains(const slab_handle& h) const noexcept {
+            return h.index < keys_.size() && keys_[h.index].generation == h.generation &&
+                   keys_[h.index].slot < slots_ && occupied(keys_[h.index].slot) &&
+                   chunk_of(keys_[h.index].slot).keys[keys_[h.index].slot % chunk_size] == h.index;
+        }
+
+        // returns nullptr if the task was erased
+        task* get(const slab_handle& h) noexcept {
+            return contains(h) ? &slot(keys_[h.index].slot) : nullptr;
+        }
+
+        const task* get(const slab_handle& h) const noexcept {
+            return contains(h) ? &slot(keys_[h.index].slot) : nullptr;
+        }
+
+        // throws std::out_of_range if the task was erased
+        task& at(const slab_handle& h) {
+            if (!contains(h)) {
+                throw std::out_of_range("stale task_slab handle");
+            }
+            return slot(keys_[h.index].slot);
+        }
+
+        slab_handle handle_of(const_iterator it) const noexcept {
+            auto index = chunk_of(it.slot_).keys[it.slot_ % chunk_size];
+            return slab_handle{index, keys_[index].generation};
+        }
+
+        std::size_t size() const noexcept {
+            return size_;
+        }
+
+        bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        // the erased slots below the highest used slot
+        std::size_t tombstones() const noexcept {
+            return slots_ - size_;
+        }
+
+        // the bytes of the task slots (without what the tasks themselves allocate)
+        std::size_t capacity_bytes() const noexcept {
+            return chunks_.size() * sizeof(chunk);
+        }
+
+        // erase(handle) and erase_if() compact once more than <fraction> of the slots are tombstones
+        // (and at least a chunk worth of them); 1 or more turns that off
+        void set_compaction_threshold(double fraction) noexcept {
+            compaction_threshold_ = fraction;
+        }
+
+        // moves the last tasks into the holes until the tasks fill the first size() slots, then frees the unused chunks;
+        // handles stay valid, iterators don't
+        void compact() {
+            std::size_t hole = 0, last = slots_;
+            for (;;) {
+                hole = next_free(hole);
+                if (hole >= size_) {
+                    break;
+                }
+                last = previous_occupied(last);
+                auto index = chunk_of(last).keys[last % chunk_size];
+                occupy(hole, index, std::move(slot(last)));
+                keys_[index].slot = static_cast<std::uint32_t>(hole);
+                vacate(last);
+            }
+            slots_ = size_;
+            free_slots_.clear();
+            chunks_.resize((slots_ + chunk_size - 1) / chunk_size);
+        }
+
+        iterator begin() noexcept { return iterator(this, next_occupied(0)); }
+        iterator end() noexcept { return iterator(this, slots_); }
+        const_iterator begin() const noexcept { return cbegin(); }
+        const_iterator end() const noexcept { return cend(); }
+        const_iterator cbegin() const noexcept { return const_iterator(this, next_occupied(0)); }
+        const_iterator cend() const noexcept { return const_iterator(this, slots_); }
+
+    private:
+        static constexpr std::size_t words = chunk_size / 64;
+
+        struct chunk {
+            std::array<task, chunk_size> tasks{};
+            // the key of the task in each slot
+            std::array<std::uint32_t, chunk_size> keys{};
+            std::array<std::uint64_t, words> occupied{};
+        };
+
+        struct key {
+            std::uint32_t slot;
+            std::uint32_t generation;
+        };
+
+        // both are only called with a word that has a bit set
+        static unsigned trailing_zeros(std::uint64_t word) noexcept {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(std::bitset<64>((word & (0 - word)) - 1).count());
+#endif
+        }
+
+        static unsigned leading_zeros(std::uint64_t word) noexcept {
+#if defined(__GNUC__)
+            return static_cast<unsigned>(__builtin_clzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanReverse64(&index, word);
+            return 63 - static_cast<unsigned>(index);
+#else
+            unsigned n = 0;
+            for (auto bit = std::uint64_t{1} << 63; (word & bit) == 0; bit >>= 1) {
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        chunk& chunk_of(std::size_t slot) noexcept { return *chunks_[slot / chunk_size]; }
+        const chunk& chunk_of(std::size_t slot) const noexcept { return *chunks_[slot / chunk_size]; }
+        task& slot(std::size_t s) noexcept { return chunk_of(s).tasks[s % chunk_size]; }
+        const task& slot(std::size_t s) const noexcept { return chunk_of(s).tasks[s % chunk_size]; }
+
+        std::uint64_t word(std::size_t slot) const noexcept {
+            return chunk_of(slot).occupied[(slot % chunk_size) / 64];
+        }
+
+        bool occupied(std::size_t slot) const noexcept {
+            return (word(slot) >> (slot % 64)) & 1;
+        }
+
+        void occupy(std::size_t slot, std::uint32_t index, task&& t) {
+            auto& c = chunk_of(slot);
+            c.tasks[slot % chunk_size] = std::move(t);
+            c.keys[slot % chunk_size] = index;
+            c.occupied[(slot % chunk_size) / 64] |= std::uint64_t{1} << (slot % 64);
+        }
+
+        // clears the slot, releasing what the task allocated
+        void vacate(std::size_t slot) {
+            auto& c = chunk_of(slot);
+            c.tasks[slot % chunk_size] = task{};
+            c.occupied[(slot % chunk_size) / 64] &= ~(std::uint64_t{1} << (slot % 64));
+        }
+
+        void release(std::size_t slot) {
+            auto index = chunk_of(slot).keys[slot % chunk_size];
+            ++keys_[index].generation;
+            free_keys_.push_back(index);
+            vacate(slot);
+            free_slots_.push_back(slot);
+            --size_;
+        }
+
+        void compact_if_sparse() {
+            if (tombstones() >= chunk_size && static_cast<double>(tombstones()) > compaction_threshold_ * static_cast<double>(slots_)) {
+                compact();
+            }
+        }
+
+        // the first occupied slot at or after <slot>, slots_ if there is none
+        std::size_t next_occupied(std::size_t slot) const noexcept {
+            while (slot < slots_) {
+                auto bits = word(slot) >> (slot % 64);
+                if (bits != 0) {
+                    return slot + trailing_zeros(bits);
+                }
+                slot = (slot / 64 + 1) * 64;
+            }
+            return slots_;
+        }
+
+        // the last occupied slot before <slot>; there has to be one
+        std::size_t previous_occupied(std::size_t slot) const noexcept {
+            for (;;) {
+                --slot;
+                auto bits = word(slot) << (63 - slot % 64);
+                if (bits != 0) {
+                    return slot - leading_zeros(bits);
+                }
+                slot -= slot % 64;
+            }
+        }
+
+        // the first free slot at or after <slot>, slots_ if there is none
+        std::size_t next_free(std::size_t slot) const noexcept {
+            while (slot < slots_) {
+                auto bits = ~word(slot) >> (slot % 64);
+                if (bits != 0) {
+                    return std::min(slot + trailing_zeros(bits), slots_);
+                }
+                slot = (slot / 64 + 1) * 64;
+            }
+            return slots_;
+        }
+
+        std::vector<std::unique_ptr<chunk>> chunks_;
+        // the slots in use or freed, all the slots from slots_ on are unused
+        std::size_t slots_ = 0;
+        std::size_t size_ = 0;
+        std::vector<std::size_t> free_slots_;
+        std::vector<key> keys_;
+        std::vector<std::uint32_t> free_keys_;
+        double compaction_threshold_ = 0.5;
+    };
+}
+
+#endif //ALGOS_TASK_SLAB_H
@@ -0,0 +1,202 @@
+#ifndef ALGOS_THREAD_POOL_H
+#define ALGOS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "parallel.h"
+
+namespace saxion {
+
+    // A fixed set of worker threads, each with its own job queue.
+    // Workers take jobs from the back of their own queue and, once it's empty, steal from the front of the others'.
+    // Threads waiting for a job_group help running the jobs instead of blocking.
+    class work_stealing_pool {
+    public:
+        using job = std::function<void()>;
+
+        explicit work_stealing_pool(unsigned threads = detail::default_thread_count())
+                : queues_(threads == 0 ? 1 : threads) {
+            for (std::size_t i = 0; i < queues_.size(); ++i) {
+                queues_[i] = std::make_unique<queue>();
+            }
+            workers_.reserve(queues_.size());
+            for (std::size_t i = 0; i < queues_.size(); ++i) {
+                workers_.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        ~work_stealing_pool() {
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                stopping_ = true;
+            }
+            idle_.notify_all();
+            for (auto& worker : workers_) {
+                worker.join();
+            }
+        }
+
+        std::size_t size() const noexcept {
+            return workers_.size();
+        }
+
+        // queues a job; jobs submitted from a worker go to that worker's own queue
+        void submit(job j) {
+            auto index = current_worker() < queues_.size() ? current_worker()
+                                                           : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                ++pending_;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+                queues_[index]->jobs.push_back(std::move(j));
+            }
+            idle_.notify_one();
+        }
+
+        // runs one queued job on the calling thread, returns false if there was none
+        bool run_one() {
+            auto self = current_worker() < queues_.size() ? current_worker() : 0;
+            job j;
+            if (!take(self, j)) {
+                return false;
+            }
+            j();
+            return true;
+        }
+
+    private:
+        struct queue {
+            std::mutex mutex;
+            std::deque<job> jobs;
+        };
+
+        static std::size_t& current_worker() noexcept {
+            thread_local std::size_t index = static_cast<std::size_t>(-1);
+            return index;
+        }
+
+        // the back of the own queue first, then the fronts of the others
+        bool take(std::size_t self, job& j) {
+            for (std::size_t k = 0; k < queues_.size(); ++k) {
+                auto& q = *queues_[(self + k) % queues_.size()];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if (q.jobs.empty()) {
+                    continue;
+                }
+                if (k == 0) {
+                    j = std::move(q.jobs.back());
+                    q.jobs.pop_back();
+                } else {
+                    j = std::move(q.jobs.front());
+                    q.jobs.pop_front();
+                }
+                std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+                --pending_;
+                return true;
+            }
+            return false;
+        }
+
+        void work(std::size_t self) {
+            current_worker() = self;
+            for (;;) {
+                job j;
+                if (take(self, j)) {
+                    j();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(idle_mutex_);
+                idle_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+                if (stopping_ && pending_ == 0) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<queue>> queues_;
+        std::vector<std::thread> workers_;
+        std::atomic<std::size_t> next_queue_{0};
+
+        std::mutex idle_mutex_;
+        std::condition_variable idle_;
+        std::size_t pending_ = 0;
+        bool stopping_ = false;
+    };
+
+    // a set of jobs run on a work_stealing_pool that can be waited for as a whole
+    class job_group {
+    public:
+        explicit job_group(work_stealing_pool& pool) : pool_(pool) {}
+
+        job_group(const job_group&) = delete;
+        job_group& operator=(const job_group&) = delete;
+
+        ~job_group() {
+            wait_no_throw();
+        }
+
+        template <typename _Fn>
+        void run(_Fn fn) {
+            remaining_.fetch_add(1, std::memory_order_relaxed);
+            pool_.submit([this, fn = std::move(fn)]() mutable {
+                try {
+                    fn();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    done_.notify_all();
+                }
+            });
+        }
+
+        // helps running the queued jobs until all the jobs of the group are done,
+        // then rethrows the first exception thrown by any of them
+        void wait() {
+            wait_no_throw();
+            if (error_) {
+                auto error = error_;
+                error_ = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        void wait_no_throw() {
+            while (remaining_.load(std::memory_order_acquire) > 0) {
+                if (pool_.run_one()) {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait(lock, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+            }
+            // the last job may still hold the mutex right after it dropped the count to zero
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+
+        work_stealing_pool& pool_;
+        std::atomic<std::size_t> remaining_{0};
+        std::mutex mutex_;
+        std::condition_variable done_;
+        std::exception_ptr error_;
+    };
+}
+
+#endif //ALGOS_THREAD_POOL_H
@@ -0,0 +1,145 @@
+#ifndef ALGOS_WORKLOAD_H
+#define ALGOS_WORKLOAD_H
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "parallel.h"
+#include "task.h"
+
+namespace saxion {
+
+    // hands out dense ids (0, 1, 2, ...) to assignee names in the order they are first seen
+    class assignee_interner {
+    public:
+        std::size_t intern(const std::string& name) {
+            auto [it, inserted] = ids_.try_emplace(name, names_.size());
+            if (inserted) {
+                names_.push_back(name);
+            }
+            return it->second;
+        }
+
+        // returns size() if <name> was never interned
+        std::size_t find(const std::string& name) const {
+            auto it = ids_.find(name);
+            return it == ids_.end() ? size() : it->second;
+        }
+
+        const std::string& name(std::size_t id) const {
+            return names_[id];
+        }
+
+        std::size_t size() const noexcept {
+            return names_.size();
+        }
+
+    private:
+        std::unordered_map<std::string, std::size_t> ids_;
+        std::vector<std::string> names_;
+    };
+
+    struct assignee_workload {
+        std::string assignee;
+        // the number of tasks <assignee> is assigned to
+        std::size_t task_count = 0;
+        // task_count divided by the number of all the tasks, the exact value algos::estimate_workload estimates
+        double workload = 0.0;
+        // same as algos::total_cost_of for <assignee>
+        double total_cost = 0.0;
+    };
+
+    // the workloads of all the assignees of a task collection, rows are indexed by interned assignee id
+    class workload_table {
+    public:
+        using const_iterator = std::vector<assignee_workload>::const_iterator;
+
+        workload_table() = default;
+
+        workload_table(assignee_interner ids, std::vector<assignee_workload> rows, std::size_t tasks)
+                : ids_(std::move(ids)), rows_(std::move(rows)), tasks_(tasks) {}
+
+        // returns nullptr if <assignee> isn't assigned to any task
+        const assignee_workload* find(const std::string& assignee) const {
+            auto id = ids_.find(assignee);
+            return id == rows_.size() ? nullptr : &rows_[id];
+        }
+
+        const assignee_workload& operator[](std::size_t id) const {
+            return rows_[id];
+        }
+
+        const_iterator begin() const noexcept { return rows_.begin(); }
+        const_iterator end() const noexcept { return rows_.end(); }
+
+        // the number of assignees
+        std::size_t size() const noexcept { return rows_.size(); }
+
+        // the number of tasks the table was computed from
+        std::size_t task_count() const noexcept { return tasks_; }
+
+    private:
+        assignee_interner ids_;
+        std::vector<assignee_workload> rows_;
+        std::size_t tasks_ = 0;
+    };
+
+    struct workloads {
+        // the minimal number of tasks a thread works on
+        static constexpr std::size_t grain = 1 << 13;
+
+        // Computes the task count, workload and total cost of every assignee in a single pass over the tasks.
+        // Every thread interns the names it meets and accumulates into its own rows,
+        // the per-thread rows are merged by name at the end.
+        template <typename _Iter>
+        workload_table assignee_workload_table(_Iter begin, _Iter end,
+                                               unsigned threads = detail::default_thread_count()) const {
+            struct partial_table {
+                assignee_interner ids;
+                std::vector<std::size_t> counts;
+                std::vector<double> costs;
+                std::size_t tasks = 0;
+            };
+            std::vector<partial_table> partial(detail::range_chunk_count(begin, end, threads, grain));
+
+            detail::parallel_ranges(begin, end, threads, grain, [&](std::size_t c, _Iter first, _Iter last) {
+                auto& table = partial[c];
+                std::for_each(first, last, [&table](const task& t) {
+                    ++table.tasks;
+                    for (auto& name : t.assignees) {
+                        auto id = table.ids.intern(name);
+                        if (id == table.counts.size()) {
+                            table.counts.push_back(0);
+                            table.costs.push_back(0.0);
+                        }
+                        ++table.counts[id];
+                        table.costs[id] += t.cost;
+                    }
+                });
+            });
+
+            assignee_interner ids;
+            std::vector<assignee_workload> rows;
+            std::size_t tasks = 0;
+            for (auto& table : partial) {
+                tasks += table.tasks;
+                for (std::size_t local = 0; local < table.ids.size(); ++local) {
+                    auto id = ids.intern(table.ids.name(local));
+                    if (id == rows.size()) {
+                        rows.push_back({table.ids.name(local), 0, 0.0, 0.0});
+                    }
+                    rows[id].task_count += table.counts[local];
+                    rows[id].total_cost += table.costs[local];
+                }
+            }
+
+            std::for_each(rows.begin(), rows.end(), [tasks](assignee_workload& row) {
+                row.workload = tasks == 0 ? 0.0 : static_cast<double>(row.task_count) / static_cast<double>(tasks);
+            });
+            return workload_table(std::move(ids), std::move(rows), tasks);
+        }
+    };
+}
+
+#endif //ALGOS_WORKLOAD_H
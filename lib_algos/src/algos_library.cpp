@@ -0,0 +1,8 @@
+// The one optimized copy of the saxion::algos members declared in algos_library.h.
+
+#define SAXION_ALGOS_BUILDING_LIBRARY
+#include "algos_library.h"
+
+namespace saxion {
+    SAXION_ALGOS_INSTANTIATE_ALL()
+}
@@ -3,10 +3,31 @@
 //
 
 #include <algorithm>
+#include <fstream>
+#include <list>
+#include <sstream>
 #include <gtest/gtest.h>
 #include "algos.h"
+#include "sort_keys.h"
+#include "histograms.h"
+#include "workload.h"
+#include "instrumentation.h"
+#include "batch_query.h"
+#include "sketches.h"
+#include "mutation_log.h"
+#include "sharded_store.h"
+#include "compressed_columns.h"
+#include "bitmap_index.h"
+#include "external_sort.h"
+#include "task_slab.h"
+#include "query_cache.h"
+#include "task_exporter.h"
+#include "task_overlay.h"
+#include "name_aggregation.h"
 #include "test_helper.h"
 
+SAXION_ALGOS_DEFINE_ALLOCATION_HOOKS
+
 
 TEST(algorithms, has_all_tasks_assigned) {
     auto tasks = test_helper::tasks();
@@ -502,3 +523,1048 @@ TEST(algorithms, average_cost_of_prio) {
         ASSERT_DOUBLE_EQ(sum / count, cost) << "Average cost for wrong for priority: " << prio;
     }
 }
+
+TEST(sort_keys, pack_orders_like_completion_comparator) {
+    auto tasks = test_helper::random_tasks(2000, 26, test_helper::hour());
+    auto keys = saxion::sort_keys();
+    auto compare = saxion::task::completion_comparator();
+
+    for (std::size_t i = 0; i + 1 < tasks.size(); ++i) {
+        auto& lhs = tasks[i];
+        auto& rhs = tasks[i + 1];
+        ASSERT_EQ(compare(lhs, rhs), keys.pack(lhs) < keys.pack(rhs)) << "Keys of tasks " << lhs.id << " and " << rhs.id;
+        ASSERT_EQ(compare(rhs, lhs), keys.pack(rhs) < keys.pack(lhs)) << "Keys of tasks " << rhs.id << " and " << lhs.id;
+    }
+
+    auto& task = tasks.front();
+    ASSERT_EQ(keys.deadline_of(keys.pack(task)), task.deadline);
+    ASSERT_EQ(keys.priority_of(keys.pack(task)), task.priority);
+}
+
+TEST(sort_keys, radix_sort_matches_std_sort) {
+    std::mt19937_64 gen(26);
+    std::vector<saxion::keyed_task> keys;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        keys.push_back({gen() % 5000, i});
+    }
+    auto expected = keys;
+    std::stable_sort(expected.begin(), expected.end(), [](auto& lhs, auto& rhs) { return lhs.key < rhs.key; });
+
+    saxion::sort_keys().sort(keys, 4);
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(expected[i].key, keys[i].key) << "Wrong key at " << i;
+        ASSERT_EQ(expected[i].index, keys[i].index) << "Radix sort should be stable, wrong index at " << i;
+    }
+}
+
+TEST(sort_keys, sorted_matches_completion_order) {
+    auto tasks = test_helper::random_tasks(50000, 26, test_helper::day());
+    auto sorted = saxion::sort_keys().sorted(tasks.begin(), tasks.end(), 3);
+
+    auto expected = tasks;
+    std::stable_sort(expected.begin(), expected.end(), saxion::task::completion_comparator());
+
+    ASSERT_EQ(expected.size(), sorted.size());
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        ASSERT_EQ(expected[i].id, tasks[sorted[i].index].id) << "Wrong task at " << i;
+    }
+}
+
+TEST(sort_keys, selection_and_burndown) {
+    auto tasks = test_helper::tasks();
+    auto keys = saxion::sort_keys();
+    auto compare = saxion::task::completion_comparator();
+
+    auto expected = tasks;
+    std::sort(expected.begin(), expected.end(), compare);
+
+    for (std::size_t n = 0; n < tasks.size(); ++n) {
+        auto& ntask = keys.nth_to_complete(tasks.begin(), tasks.end(), n);
+        ASSERT_FALSE(compare(ntask, expected[n]) || compare(expected[n], ntask)) << "Wrong task returned for n = " << n;
+    }
+    ASSERT_THROW(keys.nth_to_complete(tasks.begin(), tasks.end(), tasks.size()), std::out_of_range);
+
+    std::vector<saxion::task> first;
+    keys.first_n_to_complete(tasks.begin(), tasks.end(), 7, std::back_inserter(first));
+    ASSERT_EQ(first.size(), 7u);
+    for (std::size_t i = 0; i < first.size(); ++i) {
+        ASSERT_FALSE(compare(first[i], expected[i]) || compare(expected[i], first[i])) << "Wrong task at " << i;
+    }
+
+    std::vector<double> costs;
+    keys.cost_burndown(tasks.begin(), tasks.end(), std::back_inserter(costs));
+    std::vector<double> proper{10, 80, 110, 145, 170, 190, 220, 255, 335, 420, 425, 515, 565, 725, 770, 865, 935};
+    ASSERT_EQ(costs.size(), proper.size()) << "The count of returned accumulated costs is incorrect";
+    for (std::size_t i = 0; i < costs.size(); ++i){
+        ASSERT_DOUBLE_EQ(costs[i], proper[i]) << "Some returned values are not ok";
+    }
+}
+
+TEST(histograms, cost_histogram_matches_loop) {
+    auto tasks = test_helper::random_tasks(60000, 27, test_helper::day() * 10);
+    auto origin = test_helper::now() - test_helper::day() * 3;
+    auto width = test_helper::hour() * 6;
+    auto horizon = test_helper::day() * 7;
+
+    std::vector<double> bins(28, 0.0);
+    auto before = 0.0, after = 0.0;
+    for (auto& task : tasks) {
+        if (task.deadline < origin) {
+            before += task.cost;
+        } else if (task.deadline >= origin + horizon) {
+            after += task.cost;
+        } else {
+            bins[static_cast<std::size_t>((task.deadline - origin) / width)] += task.cost;
+        }
+    }
+
+    auto histogram = saxion::histograms().cost_histogram(tasks.begin(), tasks.end(), width, horizon, origin, 4);
+
+    ASSERT_EQ(histogram.bins.size(), bins.size()) << "The horizon should be covered by 28 buckets";
+    ASSERT_DOUBLE_EQ(histogram.before, before);
+    ASSERT_DOUBLE_EQ(histogram.after, after);
+    auto burndown = histogram.burndown();
+    auto sum = before;
+    for (std::size_t i = 0; i < bins.size(); ++i) {
+        sum += bins[i];
+        ASSERT_DOUBLE_EQ(histogram.bins[i], bins[i]) << "Wrong cost in bucket " << i;
+        ASSERT_DOUBLE_EQ(burndown[i], sum) << "Wrong cumulative cost at bucket " << i;
+    }
+}
+
+TEST(histograms, cost_histogram_groups) {
+    auto tasks = test_helper::tasks();
+    auto origin = test_helper::now();
+    auto histograms = saxion::histograms();
+
+    auto all = histograms.cost_histogram(tasks.begin(), tasks.end(), test_helper::day(), test_helper::day() * 4, origin);
+    auto by_prio = histograms.cost_histogram_by_priority(tasks.begin(), tasks.end(), test_helper::day(), test_helper::day() * 4, origin);
+    auto by_person = histograms.cost_histogram_by_assignee(tasks.begin(), tasks.end(), test_helper::day(), test_helper::day() * 4, origin);
+
+    // tasks b (7 days) & q (5 days) are after the horizon, e, f, n & r are overdue
+    ASSERT_DOUBLE_EQ(all.after, 165.0);
+    ASSERT_DOUBLE_EQ(all.before, 145.0);
+
+    auto prio_total = 0.0;
+    for (auto& [prio, bins] : by_prio) {
+        prio_total += bins.before + bins.after + std::accumulate(bins.bins.begin(), bins.bins.end(), 0.0);
+    }
+    ASSERT_DOUBLE_EQ(prio_total, saxion::algos().total_cost(tasks.begin(), tasks.end()));
+
+    for (auto& name : test_helper::assignees()) {
+        auto& bins = by_person.at(name);
+        auto total = bins.before + bins.after + std::accumulate(bins.bins.begin(), bins.bins.end(), 0.0);
+        ASSERT_DOUBLE_EQ(total, saxion::algos().total_cost_of(tasks.begin(), tasks.end(), name)) << "Wrong total for " << name;
+    }
+    ASSERT_EQ(by_person.count("frank"), 1u);
+    ASSERT_DOUBLE_EQ(by_person.at("frank").before, 30.0);
+
+    ASSERT_THROW(histograms.cost_histogram(tasks.begin(), tasks.end(), test_helper::day() * 0, test_helper::day(), origin), std::invalid_argument);
+    ASSERT_THROW(histograms.cost_histogram_by_priority(tasks.begin(), tasks.end(), -test_helper::day(), test_helper::day(), origin),
+                 std::invalid_argument);
+}
+
+TEST(workloads, assignee_workload_table) {
+    auto tasks = test_helper::random_tasks(40000, 28);
+    tasks.emplace_back(test_helper::empty_task());
+    tasks.back().assignees.emplace("zack");
+
+    auto table = saxion::workloads().assignee_workload_table(tasks.begin(), tasks.end(), 4);
+
+    ASSERT_EQ(table.task_count(), tasks.size());
+    ASSERT_EQ(table.size(), test_helper::assignees().size() + 1) << "Every assignee should have a row";
+    ASSERT_EQ(table.find("nobody"), nullptr);
+
+    auto names = test_helper::assignees();
+    names.emplace_back("zack");
+    for (auto& name : names) {
+        auto count = std::count_if(tasks.begin(), tasks.end(), [&name](auto& task) {
+            return task.assignees.count(name) == 1;
+        });
+        auto cost = 0.0;
+        for (auto& task : tasks) {
+            if (task.assignees.count(name) == 1) {
+                cost += task.cost;
+            }
+        }
+
+        auto row = table.find(name);
+        ASSERT_NE(row, nullptr) << "No row for " << name;
+        ASSERT_EQ(row->assignee, name);
+        ASSERT_EQ(row->task_count, static_cast<std::size_t>(count)) << "Wrong task count for " << name;
+        ASSERT_DOUBLE_EQ(row->workload, static_cast<double>(count) / tasks.size()) << "Wrong workload for " << name;
+        ASSERT_DOUBLE_EQ(row->total_cost, cost) << "Wrong total cost for " << name;
+    }
+}
+
+TEST(instrumentation, probe_records_calls) {
+    static saxion::instrumentation::probe_site site("instrumentation_test_probe");
+    saxion::instrumentation::reset();
+
+    for (auto i = 0; i < 3; ++i) {
+        saxion::instrumentation::scoped_probe probe(site, 10);
+        std::vector<int> allocated(100);
+        (void)allocated;
+    }
+
+    auto stats = saxion::instrumentation::snapshot();
+    auto s = std::find_if(stats.begin(), stats.end(), [](auto& s) { return s.name == "instrumentation_test_probe"; });
+    ASSERT_NE(s, stats.end()) << "The probe site should be registered";
+    ASSERT_EQ(s->calls, 3u);
+    ASSERT_EQ(s->elements, 30u);
+#ifdef SAXION_ALGOS_INSTRUMENT
+    ASSERT_EQ(s->allocations, 3u) << "Every call allocated one vector";
+#endif
+    ASSERT_EQ(std::accumulate(s->time_histogram.begin(), s->time_histogram.end(), std::uint64_t{0}), 3u);
+
+    ASSERT_NE(saxion::instrumentation::to_json(stats).find("\"instrumentation_test_probe\":{\"calls\":3"), std::string::npos);
+    ASSERT_NE(saxion::instrumentation::to_text(stats).find("instrumentation_test_probe: calls=3 elements=30"), std::string::npos);
+
+    saxion::instrumentation::reset();
+    ASSERT_EQ(site.stats().calls, 0u);
+}
+
+TEST(instrumentation, instrumented_algos) {
+    auto tasks = test_helper::tasks();
+    auto algos = saxion::instrumented_algos();
+    saxion::instrumentation::reset();
+
+    ASSERT_DOUBLE_EQ(algos.total_cost(tasks.begin(), tasks.end()), 935.0);
+    ASSERT_TRUE(algos.has_all_tasks_assigned(tasks.begin(), tasks.end()));
+
+    auto stats = saxion::instrumentation::snapshot();
+    auto s = std::find_if(stats.begin(), stats.end(), [](auto& s) { return s.name == "total_cost"; });
+#ifdef SAXION_ALGOS_INSTRUMENT
+    ASSERT_NE(s, stats.end());
+    ASSERT_EQ(s->calls, 1u);
+    ASSERT_EQ(s->elements, tasks.size());
+
+    // a list isn't walked just to count it
+    std::list<saxion::task> listed(tasks.begin(), tasks.end());
+    ASSERT_DOUBLE_EQ(algos.total_cost(listed.begin(), listed.end()), 935.0);
+    stats = saxion::instrumentation::snapshot();
+    s = std::find_if(stats.begin(), stats.end(), [](auto& s) { return s.name == "total_cost"; });
+    ASSERT_EQ(s->calls, 2u);
+    ASSERT_EQ(s->elements, tasks.size());
+#else
+    ASSERT_EQ(s, stats.end()) << "Nothing should be recorded without SAXION_ALGOS_INSTRUMENT";
+#endif
+}
+
+#ifdef SAXION_ALGOS_INSTRUMENT
+// the allocation hooks only replace the global operators in the instrumented build
+TEST(instrumentation, allocation_hooks_count_every_form) {
+    struct alignas(64) line {
+        char bytes[64];
+    };
+    auto before = saxion::instrumentation::detail::thread_allocations();
+    auto one = new int(1);
+    auto many = new int[16];
+    auto nothrow = new (std::nothrow) int[16];
+    auto aligned = new line;
+    auto aligned_many = new line[3];
+    ASSERT_EQ(saxion::instrumentation::detail::thread_allocations() - before, 5u);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned_many) % 64, 0u);
+    delete one;
+    delete[] many;
+    delete[] nothrow;
+    delete aligned;
+    delete[] aligned_many;
+}
+#endif
+
+TEST(output_buffers, tasks_with_priority_into_buffer) {
+    auto tasks = test_helper::tasks();
+    auto algos = saxion::algos();
+    auto prio = tasks[5].priority;
+    auto copies = algos.get_tasks_with_priority(tasks.begin(), tasks.end(), prio);
+
+    std::vector<std::reference_wrapper<const saxion::task>> refs;
+    refs.reserve(tasks.size());
+    std::vector<std::size_t> indices;
+    indices.reserve(tasks.size());
+
+    for (auto round = 0; round < 3; ++round) {
+        refs.clear();
+        indices.clear();
+#ifdef SAXION_ALGOS_INSTRUMENT
+        auto allocations = saxion::instrumentation::detail::thread_allocations();
+#endif
+        algos.get_tasks_with_priority(tasks.begin(), tasks.end(), prio, std::back_inserter(refs));
+        algos.get_task_indices_with_priority(tasks.begin(), tasks.end(), prio, std::back_inserter(indices));
+#ifdef SAXION_ALGOS_INSTRUMENT
+        ASSERT_EQ(allocations, saxion::instrumentation::detail::thread_allocations()) << "Reused buffers shouldn't allocate";
+#endif
+    }
+
+    ASSERT_EQ(refs.size(), copies.size());
+    ASSERT_EQ(indices.size(), copies.size());
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        ASSERT_EQ(&refs[i].get(), &tasks[indices[i]]) << "References and indices should point to the same tasks";
+        ASSERT_EQ(refs[i].get().id, copies[i].id);
+    }
+}
+
+TEST(output_buffers, sorted_and_first_n_into_buffer) {
+    auto tasks = test_helper::tasks();
+    auto algos = saxion::algos();
+
+    auto expected = algos.list_sorted_by_prio(tasks.begin(), tasks.end());
+    std::vector<saxion::algos::id_prio> sorted(tasks.size());
+    test_helper::random_shuffle(tasks);
+#ifdef SAXION_ALGOS_INSTRUMENT
+    auto allocations = saxion::instrumentation::detail::thread_allocations();
+#endif
+    auto end = algos.list_sorted_by_prio(tasks.begin(), tasks.end(), sorted.begin());
+#ifdef SAXION_ALGOS_INSTRUMENT
+    ASSERT_EQ(allocations, saxion::instrumentation::detail::thread_allocations()) << "Sorting into a buffer shouldn't allocate";
+#endif
+    ASSERT_EQ(end, sorted.end());
+    ASSERT_EQ(sorted, expected);
+
+    saxion::task first[5];
+    auto shuffled = tasks;
+    algos.get_first_n_to_complete(tasks.begin(), tasks.end(), 5, first);
+    ASSERT_TRUE(std::equal(tasks.begin(), tasks.end(), shuffled.begin(), shuffled.end(), [](auto& l, auto& r) { return l.id == r.id; }))
+        << "The range shouldn't be reordered";
+    auto all = tasks;
+    std::sort(all.begin(), all.end(), saxion::task::completion_comparator());
+    for (auto i = 0; i < 5; ++i) {
+        ASSERT_EQ(first[i].id, all[i].id) << "Wrong task at " << i;
+    }
+
+    auto [cheap, expensive] = algos.find_cheapest_and_most_expensive(tasks.begin(), tasks.end());
+    ASSERT_DOUBLE_EQ(cheap->cost, 5.0);
+    ASSERT_DOUBLE_EQ(expensive->cost, 95.0);
+}
+
+TEST(batch_query, answers_match_single_queries) {
+    auto tasks = test_helper::random_tasks(30000, 32);
+    auto now = test_helper::now();
+    saxion::work_stealing_pool pool(4);
+    saxion::batch_executor executor(pool, 1000);
+
+    std::vector<saxion::query> queries;
+    for (auto& name : test_helper::assignees()) {
+        queries.push_back(saxion::query::total_cost_of(name));
+    }
+    queries.push_back(saxion::query::total_cost_of("nobody"));
+    for (auto days = -40; days <= 40; days += 3) {
+        queries.push_back(saxion::query::count_tasks_with_deadlines_before(now + test_helper::day() * days));
+    }
+    queries.push_back(saxion::query::count_tasks_with_deadlines_before(now));
+    for (auto prio = 0; prio <= 10; ++prio) {
+        queries.push_back(saxion::query::average_cost_of_prio(prio));
+    }
+
+    auto answers = executor.run(tasks.begin(), tasks.end(), queries);
+    ASSERT_EQ(answers.size(), queries.size());
+
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        auto& q = queries[i];
+        auto sum = 0.0;
+        std::size_t count = 0;
+        for (auto& task : tasks) {
+            if ((q.what == saxion::query::kind::total_cost_of && task.assignees.count(q.assignee) == 1) ||
+                (q.what == saxion::query::kind::count_tasks_with_deadlines_before && task.deadline < q.deadline) ||
+                (q.what == saxion::query::kind::average_cost_of_prio && task.priority == q.priority)) {
+                sum += task.cost;
+                ++count;
+            }
+        }
+        switch (q.what) {
+            case saxion::query::kind::total_cost_of:
+                ASSERT_DOUBLE_EQ(answers[i], sum) << "Wrong total cost of " << q.assignee;
+                break;
+            case saxion::query::kind::count_tasks_with_deadlines_before:
+                ASSERT_EQ(answers[i], static_cast<double>(count)) << "Wrong count for query " << i;
+                break;
+            case saxion::query::kind::average_cost_of_prio:
+                if (count == 0) {
+                    ASSERT_TRUE(std::isnan(answers[i])) << "No tasks with priority " << q.priority;
+                } else {
+                    ASSERT_DOUBLE_EQ(answers[i], sum / count) << "Wrong average for priority " << q.priority;
+                }
+                break;
+        }
+    }
+}
+
+TEST(batch_query, pool_runs_and_rethrows) {
+    saxion::work_stealing_pool pool(3);
+    std::atomic<int> sum{0};
+    {
+        saxion::job_group group(pool);
+        for (auto i = 1; i <= 100; ++i) {
+            group.run([&sum, &pool, i] {
+                // jobs may spawn jobs of their own
+                saxion::job_group nested(pool);
+                nested.run([&sum, i] { sum += i; });
+                nested.wait();
+            });
+        }
+        group.wait();
+    }
+    ASSERT_EQ(sum.load(), 5050);
+
+    saxion::job_group failing(pool);
+    failing.run([] { throw std::runtime_error("job failed"); });
+    ASSERT_THROW(failing.wait(), std::runtime_error);
+}
+
+TEST(sketches, cost_quantiles_within_rank_error) {
+    auto tasks = test_helper::random_tasks(100000, 33);
+    auto by_prio = saxion::sketches().cost_quantiles_by_priority(tasks.begin(), tasks.end(), 200, 4);
+
+    ASSERT_EQ(by_prio.size(), 10u) << "There should be a sketch for each priority";
+    for (auto& [prio, sketch] : by_prio) {
+        std::vector<double> costs;
+        for (auto& task : tasks) {
+            if (task.priority == prio) {
+                costs.push_back(task.cost);
+            }
+        }
+        std::sort(costs.begin(), costs.end());
+        ASSERT_EQ(sketch.count(), costs.size());
+        ASSERT_LT(sketch.retained(), costs.size() / 10) << "The sketch should be much smaller than the data";
+
+        for (auto q : {0.5, 0.95, 0.99}) {
+            auto value = sketch.quantile(q);
+            // the true rank of the returned value has to be within the error bound of q
+            auto low = std::lower_bound(costs.begin(), costs.end(), value) - costs.begin();
+            auto high = std::upper_bound(costs.begin(), costs.end(), value) - costs.begin();
+            auto error = sketch.normalized_rank_error() * costs.size();
+            ASSERT_GE(q * costs.size() + error, low) << "p" << q * 100 << " of priority " << prio << " too high";
+            ASSERT_LE(q * costs.size() - error, high) << "p" << q * 100 << " of priority " << prio << " too low";
+        }
+    }
+
+    auto all = saxion::sketches().cost_quantiles(tasks.begin(), tasks.end(), 200, 3);
+    ASSERT_EQ(all.count(), tasks.size());
+    ASSERT_NEAR(all.rank(125.0), 0.5, all.normalized_rank_error());
+
+    // a merge that adds a level shrinks the capacities of the levels below it, those have to be compacted again
+    saxion::quantile_sketch accumulated(8);
+    for (unsigned part = 0; part < 20; ++part) {
+        saxion::quantile_sketch sketch(8, part);
+        std::for_each(tasks.begin(), tasks.begin() + 1000 + 937 * part, [&sketch](auto& t) { sketch.update(t.cost); });
+        ASSERT_TRUE(sketch.compacted());
+        accumulated.merge(sketch);
+        ASSERT_TRUE(accumulated.compacted()) << "after merging " << part + 1 << " sketches";
+    }
+    auto merged = saxion::sketches().cost_quantiles(tasks.begin(), tasks.end(), 64, 6);
+    ASSERT_TRUE(merged.compacted());
+    ASSERT_NEAR(merged.rank(125.0), 0.5, merged.normalized_rank_error());
+}
+
+TEST(sketches, distinct_counter) {
+    auto tasks = test_helper::random_tasks(20000, 33);
+    auto assignees = saxion::sketches().distinct_assignees(tasks.begin(), tasks.end(), 12, 4);
+    ASSERT_NEAR(assignees.estimate(), 5.0, 0.1);
+
+    saxion::distinct_counter lhs(12), rhs(12);
+    for (auto i = 0; i < 60000; ++i) {
+        (i % 2 == 0 ? lhs : rhs).add("person " + std::to_string(i % 50000));
+    }
+    lhs.merge(rhs);
+    ASSERT_NEAR(lhs.estimate(), 50000.0, 50000.0 * 4 * lhs.relative_error());
+
+    saxion::distinct_counter coarse(10);
+    ASSERT_THROW(lhs.merge(coarse), std::invalid_argument);
+    ASSERT_THROW(coarse.merge(lhs), std::invalid_argument);
+}
+
+namespace {
+    bool same_tasks(const std::vector<saxion::task>& lhs, const std::vector<saxion::task>& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](auto& l, auto& r) {
+            return l.id == r.id && l.name == r.name && l.priority == r.priority && l.cost == r.cost &&
+                   l.deadline == r.deadline && l.assignees == r.assignees;
+        });
+    }
+
+    std::filesystem::path fresh_directory(const std::string& name) {
+        auto directory = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(directory);
+        return directory;
+    }
+}
+
+TEST(mutation_log, binary_round_trip) {
+    auto tasks = test_helper::random_tasks(1000, 34);
+    std::vector<char> bytes;
+    saxion::binary::writer out(bytes);
+    std::for_each(tasks.begin(), tasks.end(), [&out](auto& task) { out.encode(task); });
+
+    saxion::binary::reader in(bytes.data(), bytes.size());
+    std::vector<saxion::task> decoded;
+    while (in.remaining() > 0) {
+        decoded.push_back(in.decode());
+    }
+    ASSERT_TRUE(same_tasks(tasks, decoded));
+
+    saxion::binary::reader truncated(bytes.data(), 10);
+    ASSERT_THROW(truncated.decode(), saxion::binary::format_error);
+    ASSERT_EQ(saxion::binary::crc32("123456789", 9), 0xcbf43926u);
+}
+
+TEST(mutation_log, recovers_snapshot_and_log_tail) {
+    auto directory = fresh_directory("saxion_algos_mutation_log");
+    saxion::log_options options;
+    options.group_records = 16;
+    options.sync = false;
+
+    auto tasks = test_helper::random_tasks(500, 34);
+    std::vector<saxion::task> expected;
+    {
+        saxion::logged_task_store store(directory, options);
+        for (std::size_t i = 0; i < 300; ++i) {
+            store.add_task(tasks[i]);
+        }
+        store.snapshot();
+        for (std::size_t i = 300; i < tasks.size(); ++i) {
+            store.add_task(tasks[i]);
+        }
+        store.extend_deadlines(3, test_helper::day());
+        ASSERT_TRUE(store.add_assignee_to_task(7, "Kees"));
+        ASSERT_FALSE(store.add_assignee_to_task(-1, "Kees")) << "There is no task -1";
+        store.remove_asignee_from_all("Bert");
+        store.remove_all_finished(test_helper::now());
+        store.commit();
+        expected = store.tasks();
+    }
+
+    saxion::logged_task_store recovered(directory, options);
+    ASSERT_TRUE(same_tasks(expected, recovered.tasks()));
+    ASSERT_EQ(recovered.replayed(), 204u) << "Only the mutations after the snapshot are in the log";
+    ASSERT_EQ(recovered.sequence(), 504u);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(mutation_log, truncates_torn_tail) {
+    auto directory = fresh_directory("saxion_algos_torn_log");
+    saxion::log_options options;
+    options.group_records = 1;
+    options.sync = false;
+
+    auto tasks = test_helper::random_tasks(20, 34);
+    {
+        saxion::logged_task_store store(directory, options);
+        std::for_each(tasks.begin(), tasks.end(), [&store](auto& task) { store.add_task(task); });
+    }
+    // a crash in the middle of writing the last record
+    auto log = directory / "tasks.log";
+    std::filesystem::resize_file(log, std::filesystem::file_size(log) - 5);
+
+    {
+        saxion::logged_task_store store(directory, options);
+        tasks.pop_back();
+        ASSERT_TRUE(same_tasks(tasks, store.tasks()));
+        store.add_task(test_helper::empty_task());
+    }
+    saxion::logged_task_store store(directory, options);
+    ASSERT_EQ(store.tasks().size(), 20u) << "Records appended after the truncation are recovered too";
+    ASSERT_EQ(store.tasks().back().id, 1100);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(mutation_log, clear_failure_closes_the_log) {
+    auto directory = fresh_directory("saxion_algos_closed_log");
+    std::filesystem::create_directories(directory);
+    saxion::log_options options;
+    options.sync = false;
+
+    saxion::mutation_log log(directory / "tasks.log", options);
+    std::filesystem::remove_all(directory);
+    ASSERT_THROW(log.clear(), std::system_error) << "The log cannot be truncated without its directory";
+    log.append(1, saxion::mutation::remove_asignee_from_all("Ann"));
+    ASSERT_THROW(log.flush(), std::system_error) << "A closed log cannot be written";
+
+    std::filesystem::create_directories(directory);
+    log.clear();
+    log.append(2, saxion::mutation::remove_asignee_from_all("Ann"));
+    log.flush();
+    ASSERT_EQ(saxion::mutation_log::replay(directory / "tasks.log", [](auto, const auto&) {}), 1u) << "clear() opens the log again";
+    std::filesystem::remove_all(directory);
+}
+
+#ifdef __linux__
+TEST(mutation_log, write_errors_throw) {
+    saxion::log_options options;
+    options.group_records = 2;
+
+    // every write to /dev/full fails with ENOSPC, but only once the stdio buffer is flushed
+    saxion::mutation_log log("/dev/full", options);
+    ASSERT_FALSE(log.append(1, saxion::mutation::remove_asignee_from_all("Ann")));
+    ASSERT_THROW(log.append(2, saxion::mutation::remove_asignee_from_all("Bert")), std::system_error);
+    ASSERT_THROW(log.flush(), std::system_error) << "The first record is still buffered";
+
+    ASSERT_NO_THROW(saxion::mutation_log::sync_directory(std::filesystem::temp_directory_path(), true));
+    ASSERT_THROW(saxion::mutation_log::sync_directory(fresh_directory("saxion_algos_no_directory"), true), std::system_error);
+}
+#endif
+
+TEST(sharded_store, scatter_gather_matches_algos) {
+    auto tasks = test_helper::random_tasks(20000, 35, std::chrono::hours(24));
+    auto algos = saxion::algos();
+
+    saxion::sharded_task_store store(4);
+    store.insert(tasks.begin(), tasks.begin() + 15000);
+    std::for_each(tasks.begin() + 15000, tasks.end(), [&store](auto& task) { store.insert(task); });
+    store.flush();
+
+    ASSERT_EQ(store.size(), tasks.size());
+    auto sizes = store.shard_sizes();
+    ASSERT_TRUE(std::all_of(sizes.begin(), sizes.end(), [](auto size) { return size > 4000 && size < 6000; }))
+                                << "Consecutive ids should be spread evenly over the shards";
+
+    ASSERT_DOUBLE_EQ(store.total_cost(), algos.total_cost(tasks.begin(), tasks.end()));
+    auto cutoff = test_helper::now() + test_helper::hour();
+    ASSERT_EQ(store.count_tasks_with_deadlines_before(cutoff),
+              static_cast<std::size_t>(algos.count_tasks_with_deadlines_before(tasks.begin(), tasks.end(), cutoff)));
+
+    auto ids = [&store] {
+        return store.gather([](const std::vector<saxion::task>& shard) {
+            std::vector<int> ids;
+            std::transform(shard.begin(), shard.end(), std::back_inserter(ids), [](auto& t) { return t.id; });
+            return ids;
+        });
+    };
+    auto before = ids();
+    auto first = store.get_first_n_to_complete(100);
+    ASSERT_EQ(ids(), before) << "A query must not reorder the shards";
+    auto expected = algos.get_first_n_to_complete(tasks.begin(), tasks.end(), 100);
+    ASSERT_EQ(first.size(), expected.size());
+    ASSERT_TRUE(std::equal(first.begin(), first.end(), expected.begin(), [](auto& lhs, auto& rhs) {
+        return lhs.deadline == rhs.deadline && lhs.priority == rhs.priority;
+    }));
+
+    std::vector<double> burndown;
+    store.cost_burndown(std::back_inserter(burndown));
+    std::sort(tasks.begin(), tasks.end(), saxion::task::deadline_comparator());
+    std::vector<double> expected_burndown;
+    auto sum = 0.0;
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        sum += tasks[i].cost;
+        if (i + 1 == tasks.size() || tasks[i + 1].deadline != tasks[i].deadline) {
+            expected_burndown.push_back(sum);
+        }
+    }
+    ASSERT_EQ(burndown, expected_burndown) << "Costs are multiples of 0.25, so the sums are exact";
+}
+
+TEST(compressed_columns, kernels_match_algos) {
+    auto tasks = test_helper::random_tasks(100000, 36);
+    // a few deadlines with a fraction of a second, so that some blocks need the ticks column
+    for (std::size_t i = 5000; i < tasks.size(); i += 7919) {
+        tasks[i].deadline += std::chrono::milliseconds(250);
+    }
+    auto algos = saxion::algos();
+    saxion::compressed_tasks columns(tasks.begin(), tasks.end());
+
+    ASSERT_EQ(columns.size(), tasks.size());
+    ASSERT_EQ(columns.block_count(), (tasks.size() + 1023) / 1024);
+    ASSERT_LT(columns.memory_bytes(), tasks.size() * 12) << "Less than half of the 24 bytes of id, priority, cost and deadline";
+
+    for (std::size_t i = 0; i < tasks.size(); i += 997) {
+        ASSERT_EQ(columns.id(i), tasks[i].id);
+        ASSERT_EQ(columns.priority(i), tasks[i].priority);
+        ASSERT_EQ(columns.cost(i), tasks[i].cost);
+        ASSERT_EQ(columns.deadline(i), tasks[i].deadline);
+    }
+    ASSERT_EQ(columns.find(tasks[54321].id), 54321u);
+    ASSERT_EQ(columns.find(-1), columns.size());
+
+    for (auto offset : {-test_helper::day() * 40, -test_helper::day(), test_helper::hour() * 0, test_helper::day() * 40}) {
+        auto cutoff = test_helper::now() + offset;
+        ASSERT_EQ(columns.count_tasks_with_deadlines_before(cutoff),
+                  static_cast<std::size_t>(algos.count_tasks_with_deadlines_before(tasks.begin(), tasks.end(), cutoff)));
+    }
+    auto cutoff = test_helper::now() - test_helper::day() * 20;
+    std::vector<int> ids;
+    columns.ids_with_deadlines_before(cutoff, std::back_inserter(ids));
+    ASSERT_EQ(ids.size(), columns.count_tasks_with_deadlines_before(cutoff));
+
+    ASSERT_DOUBLE_EQ(columns.total_cost(), algos.total_cost(tasks.begin(), tasks.end()));
+    ASSERT_DOUBLE_EQ(columns.average_cost_of_prio(3), algos.average_cost_of_prio(tasks.begin(), tasks.end(), 3));
+    ASSERT_EQ(columns.count_tasks_with_priority(11), 0u);
+}
+
+TEST(compressed_columns, dense_ticks_block) {
+    // consecutive seconds, each one tick later into its second than the one before: both the seconds and the ticks
+    // of the first block are dense ranges, stored without any bits
+    auto tasks = test_helper::random_tasks(1500, 37);
+    auto start = std::chrono::floor<std::chrono::seconds>(test_helper::now());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        auto n = static_cast<int>(i);
+        tasks[i].deadline = start + std::chrono::seconds(n) + saxion::task::time_difference_type(n);
+    }
+    auto algos = saxion::algos();
+    saxion::compressed_tasks columns(tasks.begin(), tasks.end());
+
+    for (std::size_t i : {0u, 1u, 2u, 511u, 1023u, 1024u, 1499u}) {
+        ASSERT_EQ(columns.deadline(i), tasks[i].deadline);
+        // just after the deadline of task i, and just before it
+        for (auto cutoff : {tasks[i].deadline + saxion::task::time_difference_type(1), tasks[i].deadline}) {
+            ASSERT_EQ(columns.count_tasks_with_deadlines_before(cutoff),
+                      static_cast<std::size_t>(algos.count_tasks_with_deadlines_before(tasks.begin(), tasks.end(), cutoff)));
+            std::vector<int> ids;
+            columns.ids_with_deadlines_before(cutoff, std::back_inserter(ids));
+            ASSERT_EQ(ids.size(), columns.count_tasks_with_deadlines_before(cutoff));
+        }
+    }
+}
+
+TEST(bitmap_index, roaring_operations) {
+    // sparse, dense and mixed containers
+    std::vector<std::uint32_t> lhs, rhs;
+    for (std::uint32_t v = 0; v < 300000; v += 3) {
+        lhs.push_back(v);
+    }
+    for (std::uint32_t v = 0; v < 300000; v += v < 100000 ? 1 : 97) {
+        rhs.push_back(v);
+    }
+    saxion::roaring_bitmap l, r;
+    std::for_each(lhs.begin(), lhs.end(), [&l](auto v) { l.add(v); });
+    std::for_each(rhs.begin(), rhs.end(), [&r](auto v) { r.add(v); });
+    ASSERT_EQ(l.cardinality(), lhs.size());
+    ASSERT_TRUE(l.contains(299997));
+    ASSERT_FALSE(l.contains(299998));
+
+    auto expect = [](const saxion::roaring_bitmap& got, const std::vector<std::uint32_t>& want) {
+        std::vector<std::uint32_t> values;
+        got.copy_to(std::back_inserter(values));
+        return got.cardinality() == want.size() && values == want;
+    };
+    std::vector<std::uint32_t> want;
+    std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(want));
+    ASSERT_TRUE(expect(l & r, want)) << "AND";
+    want.clear();
+    std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(want));
+    ASSERT_TRUE(expect(l | r, want)) << "OR";
+    want.clear();
+    std::set_difference(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(want));
+    ASSERT_TRUE(expect(and_not(l, r), want)) << "ANDNOT";
+    ASSERT_TRUE(and_not(r, r).empty());
+    ASSERT_LT(r.memory_bytes(), rhs.size()) << "Dense containers take a bit per value";
+}
+
+TEST(bitmap_index, multi_predicate_filters) {
+    auto tasks = test_helper::random_tasks(50000, 37);
+    tasks[123].assignees.clear();
+    saxion::task_bitmap_index index(tasks.begin(), tasks.end());
+
+    auto selection = index.with_priorities(3, 4) & index.assigned_to("alice") & index.assigned_to("bob");
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < tasks.size(); ++i) {
+        auto& t = tasks[i];
+        if ((t.priority == 3 || t.priority == 4) && t.assignees.count("alice") && t.assignees.count("bob")) {
+            expected.push_back(i);
+        }
+    }
+    std::vector<std::uint32_t> positions;
+    selection.copy_to(std::back_inserter(positions));
+    ASSERT_EQ(positions, expected);
+    ASSERT_EQ(index.with_priority(42).cardinality(), 0u);
+
+    ASSERT_FALSE(index.has_all_tasks_assigned());
+    ASSERT_EQ(index.unassigned().cardinality(),
+              static_cast<std::uint64_t>(std::count_if(tasks.begin(), tasks.end(), [](auto& t) { return t.assignees.empty(); })));
+    auto cost = 0.0;
+    for (auto& t : tasks) {
+        cost += t.assignees.count("cindy") ? t.cost : 0.0;
+    }
+    ASSERT_DOUBLE_EQ(index.total_cost_of(tasks.begin(), "cindy"), cost);
+    ASSERT_EQ(index.all().cardinality(), tasks.size());
+}
+
+TEST(external_sort, sorted_runs_and_merge) {
+    auto tasks = test_helper::random_tasks(100000, 38, std::chrono::hours(12));
+    std::stringstream archive;
+    std::vector<char> bytes;
+    saxion::binary::writer out(bytes);
+    std::for_each(tasks.begin(), tasks.end(), [&out](auto& task) { out.encode(task); });
+    archive.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+    saxion::external_sort_options options;
+    options.memory_budget = 64 * 1024;
+    saxion::external_algos external(options);
+
+    std::vector<saxion::algos::id_prio> sorted;
+    external.list_sorted_by_prio(saxion::binary::istream_task_iterator(archive), saxion::binary::istream_task_iterator(),
+                                 std::back_inserter(sorted));
+    ASSERT_EQ(external.stats().records, tasks.size());
+    ASSERT_GT(external.stats().runs, 10u) << "The tasks don't fit in the budget";
+    ASSERT_GT(external.stats().intermediate_merges, 0u);
+    ASSERT_LE(external.stats().peak_buffered_bytes, options.memory_budget) << "The merges stay within the budget too";
+
+    auto in_memory = tasks;
+    ASSERT_EQ(sorted, saxion::algos().list_sorted_by_prio(in_memory.begin(), in_memory.end()));
+
+    std::vector<double> burndown;
+    external.cost_burndown(tasks.begin(), tasks.end(), std::back_inserter(burndown));
+    std::vector<double> expected;
+    saxion::sort_keys().cost_burndown(tasks.begin(), tasks.end(), std::back_inserter(expected), 1);
+    ASSERT_EQ(burndown, expected) << "Deadlines are whole seconds, so grouping per second is the same";
+    ASSERT_GT(external.stats().intermediate_merges, 0u);
+    ASSERT_LE(external.stats().peak_buffered_bytes, options.memory_budget);
+
+    saxion::external_algos unbounded;
+    std::vector<double> in_budget;
+    unbounded.cost_burndown(tasks.begin(), tasks.end(), std::back_inserter(in_budget));
+    ASSERT_EQ(unbounded.stats().runs, 0u);
+    ASSERT_EQ(in_budget, expected);
+}
+
+TEST(task_slab, stable_handles_and_compaction) {
+    auto tasks = test_helper::random_tasks(10000, 40);
+    saxion::task_slab slab;
+    std::vector<saxion::slab_handle> handles;
+    std::for_each(tasks.begin(), tasks.end(), [&](auto& task) { handles.push_back(slab.insert(task)); });
+    slab.set_compaction_threshold(1.0);
+
+    for (std::size_t i = 0; i < handles.size(); i += 3) {
+        ASSERT_TRUE(slab.erase(handles[i]));
+    }
+    ASSERT_FALSE(slab.erase(handles[0])) << "Erasing twice is detected";
+    ASSERT_EQ(slab.get(handles[3]), nullptr);
+    ASSERT_THROW(slab.at(handles[6]), std::out_of_range);
+    ASSERT_EQ(slab.size(), tasks.size() - (tasks.size() + 2) / 3);
+    ASSERT_EQ(slab.tombstones(), (tasks.size() + 2) / 3);
+
+    // iteration skips the tombstones, in both directions
+    std::vector<int> ids;
+    std::transform(slab.begin(), slab.end(), std::back_inserter(ids), [](auto& task) { return task.id; });
+    ASSERT_EQ(ids.size(), slab.size());
+    ASSERT_EQ(ids.front(), tasks[1].id);
+    ASSERT_EQ(std::prev(slab.end())->id, tasks[9998].id) << "Task 9999 was erased";
+    ASSERT_EQ(std::distance(slab.begin(), slab.end()), static_cast<std::ptrdiff_t>(slab.size()));
+
+    // a reused slot gets a new handle, the old one stays stale
+    auto reused = slab.insert(test_helper::empty_task());
+    ASSERT_NE(reused, handles[9999]);
+    ASSERT_EQ(slab.at(reused).id, 1100);
+    ASSERT_EQ(slab.get(handles[9999]), nullptr);
+
+    auto algos = saxion::algos();
+    auto live_cost = slab.at(reused).cost;
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        live_cost += i % 3 == 0 ? 0.0 : tasks[i].cost;
+    }
+    ASSERT_DOUBLE_EQ(algos.total_cost(slab.begin(), slab.end()), live_cost);
+    algos.extend_deadlines(slab.begin(), slab.end(), 5, test_helper::day());
+    ASSERT_EQ(algos.get_tasks_with_priority(slab.cbegin(), slab.cend(), 5).size(),
+              static_cast<std::size_t>(std::count_if(slab.begin(), slab.end(), [](auto& task) { return task.priority == 5; })));
+
+    auto erased = slab.erase_if([](auto& task) { return task.priority > 8; });
+    ASSERT_GT(erased, 0u);
+    auto before = slab.capacity_bytes();
+    slab.compact();
+    ASSERT_EQ(slab.tombstones(), 0u);
+    ASSERT_LT(slab.capacity_bytes(), before);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        auto task = slab.get(handles[i]);
+        if (i % 3 != 0 && tasks[i].priority <= 8) {
+            ASSERT_NE(task, nullptr) << "Handles survive compaction";
+            ASSERT_EQ(task->id, tasks[i].id);
+        } else {
+            ASSERT_EQ(task, nullptr);
+        }
+    }
+}
+
+TEST(query_cache, hits_until_mutation) {
+    saxion::versioned_tasks tasks(test_helper::random_tasks(5000, 41));
+    saxion::cached_queries cache(tasks);
+    auto algos = saxion::algos();
+    auto copy = tasks.tasks();
+
+    ASSERT_DOUBLE_EQ(cache.total_cost(), algos.total_cost(copy.begin(), copy.end()));
+    ASSERT_DOUBLE_EQ(cache.total_cost(), algos.total_cost(copy.begin(), copy.end()));
+    ASSERT_DOUBLE_EQ(cache.average_cost_of_prio(2), algos.average_cost_of_prio(copy.begin(), copy.end(), 2));
+    ASSERT_DOUBLE_EQ(cache.average_cost_of_prio(3), algos.average_cost_of_prio(copy.begin(), copy.end(), 3));
+    ASSERT_DOUBLE_EQ(cache.average_cost_of_prio(2), algos.average_cost_of_prio(copy.begin(), copy.end(), 2));
+    auto [cheapest, most_expensive] = cache.cheapest_and_most_expensive();
+    ASSERT_EQ(cheapest.cost, algos.cheapest_and_most_expensive(copy.begin(), copy.end()).first.cost);
+    cache.cheapest_and_most_expensive();
+    cache.cost_burndown();
+    ASSERT_EQ(cache.stats().hits, 3u);
+    ASSERT_EQ(cache.stats().misses, 5u);
+    ASSERT_EQ(cache.size(), 5u);
+
+    auto version = tasks.version();
+    ASSERT_FALSE(tasks.add_assignee_to_task(-1, "frank"));
+    ASSERT_EQ(tasks.version(), version) << "Nothing changed";
+    cache.total_cost();
+    ASSERT_EQ(cache.stats().hits, 4u);
+
+    tasks.extend_deadlines(2, test_helper::day());
+    ASSERT_GT(tasks.version(), version);
+    cache.total_cost();
+    ASSERT_EQ(cache.stats().misses, 6u) << "A mutation invalidates the cached results";
+    ASSERT_EQ(cache.stats().invalidations, 5u);
+    ASSERT_EQ(cache.size(), 1u);
+
+    tasks.insert(test_helper::empty_task());
+    ASSERT_DOUBLE_EQ(cache.total_cost(), algos.total_cost(copy.begin(), copy.end()) + 100.0);
+    auto now = test_helper::now();
+    auto finished = std::count_if(tasks.tasks().begin(), tasks.tasks().end(), [now](const saxion::task& t) { return t.deadline <= now; });
+    ASSERT_EQ(tasks.remove_all_finished(now), static_cast<std::size_t>(finished));
+    copy = tasks.tasks();
+    ASSERT_DOUBLE_EQ(cache.average_cost_of_prio(2), algos.average_cost_of_prio(copy.begin(), copy.end(), 2));
+    ASSERT_NEAR(cache.stats().hit_rate(), 4.0 / 12.0, 1e-12);
+}
+
+TEST(task_exporter, csv_ndjson_and_binary) {
+    auto tasks = test_helper::random_tasks(3000, 42);
+    tasks[0].name = "a \"b\"\nc";
+    tasks[0].assignees = {"Doe, J", "Kim"};
+    auto directory = fresh_directory("saxion_algos_task_exporter");
+    std::filesystem::create_directories(directory);
+    auto read_lines = [](const std::filesystem::path& path) {
+        std::ifstream in(path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+
+    {
+        // a small buffer, so it is flushed many times
+        saxion::task_exporter out(directory / "tasks.bin", saxion::export_format::binary, 4096);
+        ASSERT_EQ(out.write_tasks(tasks.begin(), tasks.end()), tasks.size());
+        out.flush();
+        ASSERT_EQ(out.bytes_written(), std::filesystem::file_size(directory / "tasks.bin"));
+    }
+    std::ifstream binary(directory / "tasks.bin", std::ios::binary);
+    std::vector<saxion::task> decoded(saxion::binary::istream_task_iterator{binary}, saxion::binary::istream_task_iterator{});
+    ASSERT_TRUE(same_tasks(tasks, decoded));
+
+    {
+        saxion::task_exporter out(directory / "tasks.csv", saxion::export_format::csv, 4096);
+        out.write_tasks(tasks.begin(), tasks.end());
+    }
+    auto csv = read_lines(directory / "tasks.csv");
+    ASSERT_EQ(csv.size(), tasks.size() + 2) << "The header, and the name of tasks[0] takes two lines";
+    auto nanoseconds = [](auto& t) {
+        return std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(t.deadline.time_since_epoch()).count());
+    };
+    std::ostringstream expected;
+    // RFC 4180: the fields with a quote, comma or line break are quoted, and their quotes doubled
+    expected << "id,name,priority,cost,deadline,assignees\n"
+             << tasks[0].id << ",\"a \"\"b\"\"\nc\"," << tasks[0].priority << ',' << tasks[0].cost << ','
+             << nanoseconds(tasks[0]) << ",\"Doe, J;Kim\"\n";
+    auto& t = tasks[1];
+    expected << t.id << ',' << t.name << ',' << t.priority << ',' << t.cost << ',' << nanoseconds(t) << ',';
+    for (auto& name : t.assignees) {
+        expected << name << (name == *t.assignees.rbegin() ? "" : ";");
+    }
+    expected << '\n';
+    std::ifstream csv_file(directory / "tasks.csv", std::ios::binary);
+    std::string head(expected.str().size(), '\0');
+    csv_file.read(head.data(), static_cast<std::streamsize>(head.size()));
+    ASSERT_EQ(head, expected.str());
+
+    std::vector<double> burndown;
+    auto sorted = tasks;
+    std::sort(sorted.begin(), sorted.end(), saxion::task::deadline_comparator{});
+    double total = 0;
+    std::transform(sorted.begin(), sorted.end(), std::back_inserter(burndown), [&total](auto& t) { return total += t.cost; });
+    {
+        saxion::task_exporter out(directory / "tasks.ndjson", saxion::export_format::ndjson);
+        out.write_tasks(tasks.begin(), tasks.begin() + 1);
+        ASSERT_EQ(out.write_costs(burndown.begin(), burndown.begin() + 2), 2u);
+        auto prios = saxion::algos().list_sorted_by_prio(tasks.begin(), tasks.begin() + 1);
+        out.write_id_prios(prios.begin(), prios.end());
+    }
+    auto ndjson = read_lines(directory / "tasks.ndjson");
+    ASSERT_EQ(ndjson.size(), 4u);
+    ASSERT_NE(ndjson[0].find(R"("name":"a \"b\"\u000ac")"), std::string::npos) << ndjson[0];
+    ASSERT_EQ(std::stod(ndjson[1]), burndown[0]);
+    ASSERT_EQ(std::stod(ndjson[2]), burndown[1]);
+    ASSERT_EQ(ndjson[3], "{\"id\":" + std::to_string(tasks[0].id) + ",\"priority\":" + std::to_string(tasks[0].priority) + "}");
+    std::filesystem::remove_all(directory);
+}
+
+TEST(task_overlay, scenarios_match_deep_copies) {
+    const auto base = test_helper::random_tasks(5000, 43);
+    auto algos = saxion::algos();
+    auto deadline = test_helper::now() + 3 * test_helper::day();
+
+    saxion::task_overlay scenario(base);
+    scenario.extend_deadlines(5, 2 * test_helper::day());
+    scenario.remove_asignee_from_all("bob");
+    auto copy = base;
+    algos.extend_deadlines(copy.begin(), copy.end(), 5, 2 * test_helper::day());
+    algos.remove_asignee_from_all(copy.begin(), copy.end(), "bob");
+
+    auto touched = std::count_if(base.begin(), base.end(), [](auto& t) { return t.priority == 5 || t.assignees.count("bob") != 0; });
+    ASSERT_EQ(scenario.changed(), static_cast<std::size_t>(touched)) << "Only the changed tasks are copied";
+    ASSERT_TRUE(same_tasks(scenario.materialize(), copy));
+    ASSERT_TRUE(std::equal(copy.rbegin(), copy.rend(), std::make_reverse_iterator(scenario.end()), std::make_reverse_iterator(scenario.begin()),
+                           [](auto& l, auto& r) { return l.id == r.id && l.deadline == r.deadline && l.assignees == r.assignees; }));
+    ASSERT_EQ(scenario[42].assignees, copy[42].assignees);
+
+    ASSERT_EQ(algos.count_tasks_with_deadlines_before(scenario.begin(), scenario.end(), deadline),
+              algos.count_tasks_with_deadlines_before(copy.begin(), copy.end(), deadline));
+    ASSERT_EQ(algos.total_cost_of(scenario.begin(), scenario.end(), "bob"), 0.0);
+    std::vector<double> expected, burndown;
+    saxion::sort_keys().cost_burndown(copy.begin(), copy.end(), std::back_inserter(expected));
+    saxion::sort_keys().cost_burndown(scenario.begin(), scenario.end(), std::back_inserter(burndown));
+    ASSERT_EQ(burndown, expected);
+
+    // a branch of the scenario doesn't affect it, nor the base
+    auto branch = scenario;
+    branch.extend_deadlines(5, test_helper::day());
+    ASSERT_EQ(branch.changed(), scenario.changed());
+    ASSERT_EQ(algos.count_tasks_with_deadlines_before(scenario.begin(), scenario.end(), deadline),
+              algos.count_tasks_with_deadlines_before(copy.begin(), copy.end(), deadline));
+    ASSERT_TRUE(std::any_of(base.begin(), base.end(), [](auto& t) { return t.assignees.count("bob") != 0; }));
+    scenario.reset();
+    ASSERT_TRUE(same_tasks(scenario.materialize(), base));
+}
+
+TEST(name_aggregation, matches_sorted_grouping) {
+    auto tasks = test_helper::random_tasks(50000, 44);
+    for (auto& t : tasks) {
+        t.name = "task " + std::to_string(t.id * 7919 % 1000);
+    }
+    const auto original = tasks;
+
+    auto sorted = tasks;
+    std::stable_sort(sorted.begin(), sorted.end(), saxion::task::name_comparator{});
+    std::vector<saxion::name_group> expected;
+    for (auto& t : sorted) {
+        if (expected.empty() || expected.back().name != t.name) {
+            expected.push_back(saxion::name_group{t.name, 0, 0.0, t.deadline, t.deadline, {}});
+        }
+        auto& g = expected.back();
+        ++g.count;
+        g.total_cost += t.cost;
+        g.earliest_deadline = std::min(g.earliest_deadline, t.deadline);
+        g.latest_deadline = std::max(g.latest_deadline, t.deadline);
+        g.assignees.insert(t.assignees.begin(), t.assignees.end());
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        auto groups = saxion::name_aggregation().group_by_name(tasks.begin(), tasks.end(), threads);
+        ASSERT_TRUE(same_tasks(tasks, original)) << "The input isn't reordered";
+        ASSERT_EQ(groups.size(), 1000u);
+        ASSERT_EQ(groups[0].name, tasks[0].name) << "Groups are in order of first appearance";
+        std::sort(groups.begin(), groups.end(), [](auto& l, auto& r) { return l.name < r.name; });
+        ASSERT_EQ(groups.size(), expected.size());
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            auto& g = groups[i];
+            auto& e = expected[i];
+            ASSERT_EQ(g.name, e.name) << threads << " threads";
+            ASSERT_EQ(g.count, e.count) << g.name;
+            // the threads add the costs up in another order, so the sums may differ in the last bits
+            ASSERT_NEAR(g.total_cost, e.total_cost, 1e-9 * e.total_cost) << g.name;
+            ASSERT_EQ(g.earliest_deadline, e.earliest_deadline) << g.name;
+            ASSERT_EQ(g.latest_deadline, e.latest_deadline) << g.name;
+            ASSERT_EQ(g.assignees, e.assignees) << g.name;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+// The tests of lib_algos_compiled, in an executable of their own: no other translation unit instantiates the algos
+// members, so all the members used here, also by the header-only components, have to come from the library.
+// All the headers have to be includable after algos_library.h; instrumentation.h is left out, as it brings
+// the member definitions along.
+
+#include <deque>
+#include <gtest/gtest.h>
+#include "algos_library.h"
+#include "batch_query.h"
+#include "bitmap_index.h"
+#include "compressed_columns.h"
+#include "external_sort.h"
+#include "histograms.h"
+#include "mutation_log.h"
+#include "name_aggregation.h"
+#include "query_cache.h"
+#include "sharded_store.h"
+#include "sketches.h"
+#include "sort_keys.h"
+#include "task_exporter.h"
+#include "task_overlay.h"
+#include "task_slab.h"
+#include "workload.h"
+#include "test_helper.h"
+
+TEST(compiled_library, deque_and_pointer_ranges) {
+    auto tasks = test_helper::random_tasks(1000, 39);
+    std::deque<saxion::task> deque(tasks.begin(), tasks.end());
+    auto algos = saxion::algos();
+
+    auto expected = algos.total_cost(tasks.begin(), tasks.end());
+    ASSERT_DOUBLE_EQ(algos.total_cost(deque.begin(), deque.end()), expected);
+    ASSERT_DOUBLE_EQ(algos.total_cost(tasks.data(), tasks.data() + tasks.size()), expected);
+
+    auto cutoff = test_helper::now();
+    ASSERT_EQ(algos.count_tasks_with_deadlines_before(deque.begin(), deque.end(), cutoff),
+              algos.count_tasks_with_deadlines_before(tasks.data(), tasks.data() + tasks.size(), cutoff));
+
+    auto from_deque = algos.list_sorted_by_prio(deque.begin(), deque.end());
+    auto from_pointers = algos.list_sorted_by_prio(tasks.data(), tasks.data() + tasks.size());
+    ASSERT_EQ(from_deque, from_pointers);
+
+    auto first = algos.get_first_n_to_complete(deque.begin(), deque.end(), 10);
+    ASSERT_EQ(first.size(), 10u);
+    ASSERT_TRUE(std::is_sorted(first.begin(), first.end(), saxion::task::completion_comparator()));
+}
+
+TEST(compiled_library, header_only_components) {
+    auto tasks = test_helper::random_tasks(1000, 39);
+    auto algos = saxion::algos();
+    auto cutoff = test_helper::now();
+
+    // const_iterators of the shards
+    saxion::sharded_task_store store(3);
+    store.insert(tasks.begin(), tasks.end());
+    ASSERT_DOUBLE_EQ(store.total_cost(), algos.total_cost(tasks.begin(), tasks.end()));
+    ASSERT_EQ(store.count_tasks_with_deadlines_before(cutoff),
+              static_cast<std::size_t>(algos.count_tasks_with_deadlines_before(tasks.begin(), tasks.end(), cutoff)));
+    ASSERT_EQ(store.get_first_n_to_complete(10).size(), 10u);
+
+    saxion::versioned_tasks versioned(tasks);
+    saxion::cached_queries cache(versioned);
+    ASSERT_DOUBLE_EQ(cache.total_cost(), algos.total_cost(tasks.begin(), tasks.end()));
+    versioned.extend_deadlines(3, test_helper::day());
+    ASSERT_EQ(cache.cheapest_and_most_expensive().first.cost, algos.cheapest_and_most_expensive(tasks.begin(), tasks.end()).first.cost);
+}
@@ -86,6 +86,30 @@ struct test_helper{
         return tasks;
     }
 
+    // <count> tasks with random deadlines (whole seconds, within <spread> of now), priorities, costs and assignees
+    static auto random_tasks(std::size_t count, unsigned seed, saxion::task::time_difference_type spread = std::chrono::hours(24 * 30)) {
+        auto names = assignees();
+        std::mt19937 gen(seed);
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(spread).count();
+        std::uniform_int_distribution<long long> deadline(-seconds, seconds);
+        std::uniform_int_distribution<int> priority(1, 10);
+        std::uniform_int_distribution<int> cost(0, 1000);
+        std::uniform_int_distribution<std::size_t> name(0, names.size() - 1);
+        auto origin = std::chrono::time_point_cast<std::chrono::seconds>(now());
+
+        std::vector<saxion::task> tasks;
+        tasks.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            saxion::task t{static_cast<int>(i + 1), "task " + std::to_string(i % 97), priority(gen), cost(gen) / 4.0,
+                           origin + std::chrono::seconds(deadline(gen)), {}};
+            for (auto n = name(gen); n < names.size(); n += 1 + name(gen)) {
+                t.assignees.emplace(names[n]);
+            }
+            tasks.emplace_back(std::move(t));
+        }
+        return tasks;
+    }
+
     static auto empty_task(){
         return saxion::task{1100, "task x", 1, 100.0, now() - day(), {} };
     }